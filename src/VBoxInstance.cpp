@@ -10,11 +10,15 @@
 
 #include "timeshift/DummyBuffer.h"
 #include "timeshift/FilesystemBuffer.h"
+#include "timeshift/MemoryBuffer.h"
+#include "timeshift/TieredBuffer.h"
 #include "vbox/ContentIdentifier.h"
 #include "vbox/RecordingReader.h"
 #include "vbox/InstanceSettings.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 
 #include <kodi/General.h>
 
@@ -23,6 +27,7 @@ using namespace vbox;
 // settings context menu
 unsigned int MENUHOOK_ID_RESCAN_EPG = 1;
 unsigned int MENUHOOK_ID_SYNC_EPG = 2;
+unsigned int MENUHOOK_ID_REQUEST_STATISTICS = 3;
 
 CVBoxInstance::CVBoxInstance(const kodi::addon::IInstanceInfo& instance)
   : kodi::addon::CInstancePVRClient(instance), VBox()
@@ -58,25 +63,39 @@ ADDON_STATUS CVBoxInstance::Initialize()
       VBox::OnChannelsUpdated = [this]() { kodi::addon::CInstancePVRClient::TriggerChannelUpdate(); };
       VBox::OnRecordingsUpdated = [this]() { kodi::addon::CInstancePVRClient::TriggerRecordingUpdate(); };
       VBox::OnTimersUpdated = [this]() { kodi::addon::CInstancePVRClient::TriggerTimerUpdate(); };
-      VBox::OnGuideUpdated = [this]()
+      VBox::OnGuideUpdated = [this](const std::vector<ChannelPtr>& channels)
       {
-        for (const auto& channel : VBox::GetChannels())
+        for (const auto& channel : channels)
         {
           kodi::addon::CInstancePVRClient::TriggerEpgUpdate(ContentIdentifier::GetUniqueId(channel));
         }
       };
 
-      // Create the timeshift buffer
-      if (m_settings->m_timeshiftEnabled)
-        m_timeshiftBuffer = new timeshift::FilesystemBuffer(m_settings->m_timeshiftBufferPath);
+      // Create the timeshift buffer. The memory size is computed in 64 bits
+      // since the largest setting doesn't fit in a 32-bit size_t, in which
+      // case allocating the buffer fails and is logged instead
+      uint64_t memorySize = static_cast<uint64_t>(m_settings->m_timeshiftMemorySize) * 1024 * 1024;
+      size_t timeshiftMemorySize = static_cast<size_t>(
+          std::min<uint64_t>(memorySize, std::numeric_limits<size_t>::max()));
+
+      if (m_settings->m_timeshiftEnabled && m_settings->m_timeshiftBufferType == TIMESHIFT_BUFFER_MEMORY)
+        m_timeshiftBuffer = new timeshift::MemoryBuffer(timeshiftMemorySize);
+      else if (m_settings->m_timeshiftEnabled && m_settings->m_timeshiftBufferType == TIMESHIFT_BUFFER_TIERED)
+        m_timeshiftBuffer = new timeshift::TieredBuffer(m_settings->m_timeshiftBufferPath, timeshiftMemorySize,
+                                                        static_cast<int64_t>(m_settings->m_timeshiftBufferSize) * 1024 * 1024);
+      else if (m_settings->m_timeshiftEnabled)
+        m_timeshiftBuffer = new timeshift::FilesystemBuffer(m_settings->m_timeshiftBufferPath,
+                                                            static_cast<int64_t>(m_settings->m_timeshiftBufferSize) * 1024 * 1024);
       else
         m_timeshiftBuffer = new timeshift::DummyBuffer();
 
       m_timeshiftBuffer->SetReadTimeout(VBox::GetConnectionParams().timeout);
+      m_timeshiftBuffer->SetLowLatency(m_settings->m_timeshiftLowLatency);
 
       // initializing TV Settings Client Specific menu hooks
       std::vector<kodi::addon::PVRMenuhook> hooks = {{MENUHOOK_ID_RESCAN_EPG, 30106, PVR_MENUHOOK_SETTING},
-                                                     {MENUHOOK_ID_SYNC_EPG, 30107, PVR_MENUHOOK_SETTING}};
+                                                     {MENUHOOK_ID_SYNC_EPG, 30107, PVR_MENUHOOK_SETTING},
+                                                     {MENUHOOK_ID_REQUEST_STATISTICS, 30108, PVR_MENUHOOK_SETTING}};
 
       for (auto& hook : hooks)
         kodi::addon::CInstancePVRClient::AddMenuHook(hook);
@@ -181,6 +200,12 @@ PVR_ERROR CVBoxInstance::CallSettingsMenuHook(const kodi::addon::PVRMenuhook& me
     VBox::SyncEPGNow();
     return PVR_ERROR_NO_ERROR;
   }
+  else if (menuhook.GetHookId() == MENUHOOK_ID_REQUEST_STATISTICS)
+  {
+    VBox::LogRequestStatistics(ADDON_LOG_INFO);
+    kodi::QueueNotification(QUEUE_INFO, "", "Request statistics written to the log");
+    return PVR_ERROR_NO_ERROR;
+  }
   return PVR_ERROR_INVALID_PARAMETERS;
 }
 
@@ -200,10 +225,10 @@ PVR_ERROR CVBoxInstance::GetChannelsAmount(int& amount)
 
 PVR_ERROR CVBoxInstance::GetChannels(bool radio, kodi::addon::PVRChannelsResultSet& results)
 {
-  auto& channels = VBox::GetChannels();
+  auto channels = VBox::GetChannels();
   unsigned int i = 0;
 
-  for (const auto& item : channels)
+  for (const auto& item : *channels)
   {
     // Skip those that are not of the correct type
     if (item->m_radio != radio)
@@ -277,9 +302,9 @@ PVR_ERROR CVBoxInstance::GetRecordingsAmount(bool deleted, int& amount)
 
 PVR_ERROR CVBoxInstance::GetRecordings(bool deleted, kodi::addon::PVRRecordingsResultSet& results)
 {
-  auto& recordings = VBox::GetRecordingsAndTimers();
+  auto recordings = VBox::GetRecordingsAndTimers();
 
-  for (const auto& item : recordings)
+  for (const auto& item : *recordings)
   {
     // Skip timers
     if (!item->IsRecording())
@@ -289,8 +314,8 @@ PVR_ERROR CVBoxInstance::GetRecordings(bool deleted, kodi::addon::PVRRecordingsR
     recording.SetSeriesNumber(PVR_RECORDING_INVALID_SERIES_EPISODE);
     recording.SetEpisodeNumber(PVR_RECORDING_INVALID_SERIES_EPISODE);
 
-    time_t startTime = xmltv::Utilities::XmltvToUnixTime(item->m_startTime);
-    time_t endTime = xmltv::Utilities::XmltvToUnixTime(item->m_endTime);
+    time_t startTime = item->m_startTimestamp;
+    time_t endTime = item->m_endTimestamp;
     unsigned int id = item->m_id;
 
     recording.SetRecordingTime(startTime);
@@ -310,18 +335,10 @@ PVR_ERROR CVBoxInstance::GetRecordings(bool deleted, kodi::addon::PVRRecordingsR
     recording.SetChannelType(PVR_RECORDING_CHANNEL_TYPE_UNKNOWN);
 
     // Find the recordings channel and use its unique ID if we find one
-    auto& channels = VBox::GetChannels();
-    auto it = std::find_if(
-      channels.cbegin(),
-      channels.cend(),
-      [&item](const ChannelPtr& channel) {
-        return channel->m_xmltvName == item->m_channelId;
-      }
-    );
+    ChannelPtr channel = VBox::GetChannelByXmltvName(item->m_channelId);
 
-    if (it != channels.cend())
+    if (channel)
     {
-      ChannelPtr channel = *it;
       recording.SetChannelUid(ContentIdentifier::GetUniqueId(channel));
       if (channel->m_radio)
         recording.SetChannelType(PVR_RECORDING_CHANNEL_TYPE_RADIO);
@@ -444,10 +461,10 @@ PVR_ERROR CVBoxInstance::GetTimersAmount(int& amount)
 PVR_ERROR CVBoxInstance::GetTimers(kodi::addon::PVRTimersResultSet& results)
 {
   /* TODO: Change implementation to get support for the timer features introduced with PVR API 1.9.7 */
-  auto& recordings = VBox::GetRecordingsAndTimers();
+  auto recordings = VBox::GetRecordingsAndTimers();
 
   // first get timers from single recordings (scheduled)
-  for (const auto& item : recordings)
+  for (const auto& item : *recordings)
   {
     // Skip recordings
     if (!item->IsTimer())
@@ -455,8 +472,8 @@ PVR_ERROR CVBoxInstance::GetTimers(kodi::addon::PVRTimersResultSet& results)
 
     kodi::addon::PVRTimer timer;
     timer.SetTimerType((item->m_seriesId > 0) ? vbox::TIMER_VBOX_TYPE_EPISODE : vbox::TIMER_VBOX_TYPE_MANUAL_SINGLE);
-    timer.SetStartTime(xmltv::Utilities::XmltvToUnixTime(item->m_startTime));
-    timer.SetEndTime(xmltv::Utilities::XmltvToUnixTime(item->m_endTime));
+    timer.SetStartTime(item->m_startTimestamp);
+    timer.SetEndTime(item->m_endTimestamp);
     timer.SetClientIndex(item->m_id);
 
     // Convert the internal timer state to PVR_TIMER_STATE
@@ -477,15 +494,10 @@ PVR_ERROR CVBoxInstance::GetTimers(kodi::addon::PVRTimersResultSet& results)
     }
 
     // Find the timer's channel and use its unique ID
-    auto& channels = VBox::GetChannels();
-    auto it = std::find_if(channels.cbegin(), channels.cend(),
-      [&item](const ChannelPtr& channel) {
-        return channel->m_xmltvName == item->m_channelId;
-      }
-    );
+    ChannelPtr channel = VBox::GetChannelByXmltvName(item->m_channelId);
 
-    if (it != channels.cend())
-      timer.SetClientChannelUid(ContentIdentifier::GetUniqueId(*it));
+    if (channel)
+      timer.SetClientChannelUid(ContentIdentifier::GetUniqueId(channel));
     else
       continue;
 
@@ -497,8 +509,8 @@ PVR_ERROR CVBoxInstance::GetTimers(kodi::addon::PVRTimersResultSet& results)
     results.Add(timer);
   }
   // second: get timer rules for series
-  auto& series = VBox::GetSeriesTimers();
-  for (const auto& item : series)
+  auto series = VBox::GetSeriesTimers();
+  for (const auto& item : *series)
   {
     kodi::addon::PVRTimer timer;
 
@@ -507,28 +519,23 @@ PVR_ERROR CVBoxInstance::GetTimers(kodi::addon::PVRTimersResultSet& results)
     timer.SetState(PVR_TIMER_STATE_SCHEDULED);
 
     // Find the timer's channel and use its unique ID
-    auto& channels = VBox::GetChannels();
-    auto it = std::find_if(channels.cbegin(), channels.cend(),
-      [&item](const ChannelPtr& channel) {
-        return channel->m_xmltvName == item->m_channelId;
-      }
-    );
+    ChannelPtr channel = VBox::GetChannelByXmltvName(item->m_channelId);
 
-    if (it != channels.cend())
-      timer.SetClientChannelUid(ContentIdentifier::GetUniqueId(*it));
+    if (channel)
+      timer.SetClientChannelUid(ContentIdentifier::GetUniqueId(channel));
 
     unsigned int nextScheduledId = item->m_scheduledId;
     // Find next recording of the series
-    auto recIt = std::find_if(recordings.begin(), recordings.end(),
+    auto recIt = std::find_if(recordings->begin(), recordings->end(),
       [nextScheduledId](const RecordingPtr& recording) {
         return nextScheduledId == recording->m_id;
       }
     );
     // if it doesn't exist (canceled) - don't add series
-    if (recIt == recordings.end())
+    if (recIt == recordings->end())
       continue;
 
-    timer.SetStartTime(xmltv::Utilities::XmltvToUnixTime(item->m_startTime));
+    timer.SetStartTime(item->m_startTimestamp);
     // automatic starts & stops whenever detected (will appear as episode)
     if (item->m_fIsAuto)
     {
@@ -538,9 +545,9 @@ PVR_ERROR CVBoxInstance::GetTimers(kodi::addon::PVRTimersResultSet& results)
     else
     {
       // set periodic times
-      timer.SetFirstDay(xmltv::Utilities::XmltvToUnixTime(item->m_startTime));
+      timer.SetFirstDay(item->m_startTimestamp);
       timer.SetWeekdays(item->m_weekdays);
-      timer.SetEndTime(xmltv::Utilities::XmltvToUnixTime(item->m_endTime));
+      timer.SetEndTime(item->m_endTimestamp);
     }
     timer.SetTitle(item->m_title);
 
@@ -556,18 +563,11 @@ PVR_ERROR CVBoxInstance::AddTimer(const kodi::addon::PVRTimer& timer)
 {
   kodi::Log(ADDON_LOG_DEBUG, "AddTimer() : entering with timer type 0x%x", timer.GetTimerType());
   // Find the channel the timer is for
-  auto& channels = VBox::GetChannels();
-  auto it = std::find_if(channels.cbegin(), channels.cend(),
-    [&timer](const ChannelPtr& channel) {
-      return timer.GetClientChannelUid() == ContentIdentifier::GetUniqueId(channel);
-    }
-  );
+  const ChannelPtr channel = VBox::GetChannel(timer.GetClientChannelUid());
 
-  if (it == channels.end())
+  if (!channel)
     return PVR_ERROR_INVALID_PARAMETERS;
 
-  const ChannelPtr channel = *it;
-
   // Find the channel's schedule
   const Schedule schedule = VBox::GetSchedule(channel);
 
@@ -681,8 +681,8 @@ PVR_ERROR CVBoxInstance::GetEPGForChannel(int channelUid, time_t start, time_t e
   {
     kodi::addon::PVREPGTag event;
 
-    event.SetStartTime(xmltv::Utilities::XmltvToUnixTime(programme->m_startTime));
-    event.SetEndTime(xmltv::Utilities::XmltvToUnixTime(programme->m_endTime));
+    event.SetStartTime(programme->m_startTimestamp);
+    event.SetEndTime(programme->m_endTimestamp);
     event.SetUniqueChannelId(channelUid);
     event.SetUniqueBroadcastId(ContentIdentifier::GetUniqueId(programme.get()));
     event.SetTitle(programme->m_title);
@@ -796,11 +796,17 @@ PVR_ERROR CVBoxInstance::GetStreamTimes(kodi::addon::PVRStreamTimes& times)
   // Addon API 5.8.0
   if (IsRealTimeStream() && m_timeshiftBuffer && m_settings->m_timeshiftEnabled)
   {
-    times.SetStartTime(m_timeshiftBuffer->GetStartTime());
+    // All times are relative to when the stream started. The oldest data may
+    // have been overwritten, in which case the window begins later
+    time_t startTime = m_timeshiftBuffer->GetStartTime();
+    bool canSeek = m_timeshiftBuffer->CanSeekStream();
+
+    times.SetStartTime(startTime);
     times.SetPTSStart(0);
-    times.SetPTSBegin(0);
-    times.SetPTSEnd((!m_timeshiftBuffer->CanSeekStream()) ? 0
-        : (m_timeshiftBuffer->GetEndTime() - m_timeshiftBuffer->GetStartTime()) * STREAM_TIME_BASE);
+    times.SetPTSBegin((!canSeek) ? 0
+        : (m_timeshiftBuffer->GetWindowStartTime() - startTime) * STREAM_TIME_BASE);
+    times.SetPTSEnd((!canSeek) ? 0
+        : (m_timeshiftBuffer->GetEndTime() - startTime) * STREAM_TIME_BASE);
 
     return PVR_ERROR_NO_ERROR;
   }
@@ -828,29 +834,29 @@ bool CVBoxInstance::OpenRecordedStream(const kodi::addon::PVRRecording & recordi
   CloseRecordedStream();
 
   unsigned int id = static_cast<unsigned int>(std::stoi(recording.GetRecordingId()));
-  auto& recordings = VBox::GetRecordingsAndTimers();
-  auto recIt = std::find_if(recordings.begin(), recordings.end(),
+  auto recordings = VBox::GetRecordingsAndTimers();
+  auto recIt = std::find_if(recordings->begin(), recordings->end(),
     [id](const RecordingPtr& item) {
       return item->IsRecording() && id == item->m_id;
     }
   );
 
-  if (recIt == recordings.end())
+  if (recIt == recordings->end())
     return PVR_ERROR_SERVER_ERROR;
 
   std::time_t now = std::time(nullptr), start = 0, end = 0;
   std::string channelName = recording.GetChannelName();
   time_t recordingTime = recording.GetRecordingTime();
-  auto timerIt = std::find_if(recordings.begin(), recordings.end(),
+  auto timerIt = std::find_if(recordings->begin(), recordings->end(),
     [now, channelName, recordingTime](const RecordingPtr& item) {
       return item->IsTimer() && item->IsRunning(now, channelName, recordingTime);
     }
   );
-  if (timerIt != recordings.end())
+  if (timerIt != recordings->end())
   {
     auto& timer = *timerIt;
-    start = xmltv::Utilities::XmltvToUnixTime(timer->m_startTime);
-    end = xmltv::Utilities::XmltvToUnixTime(timer->m_endTime);
+    start = timer->m_startTimestamp;
+    end = timer->m_endTimestamp;
   }
 
   m_recordingReader = new RecordingReader((*recIt)->m_url.c_str(), start, end, recording.GetDuration());
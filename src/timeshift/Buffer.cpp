@@ -8,12 +8,16 @@
 
 #include "Buffer.h"
 
+#include <algorithm>
 #include <sstream>
 
 using namespace timeshift;
 
 const int Buffer::DEFAULT_READ_TIMEOUT = 10;
 
+// Seven TS packets, i.e. what the gateway sends in a single datagram
+const size_t Buffer::LOW_LATENCY_READ_LENGTH = 188 * 7;
+
 bool Buffer::Open(const std::string inputUrl)
 {
   // Append the read timeout parameter
@@ -22,6 +26,10 @@ bool Buffer::Open(const std::string inputUrl)
 
   // Remember the start time and open the input
   m_startTime = time(nullptr);
+  m_openTime = std::chrono::steady_clock::now();
+  m_firstDataLatency = std::chrono::milliseconds(-1);
+  m_reads = m_waits = m_timeouts = 0;
+  m_totalWaitTime = m_longestWaitTime = std::chrono::milliseconds(0);
 
   return m_inputHandle.OpenFile(ss.str(), ADDON_READ_NO_CACHE);
 }
@@ -33,6 +41,9 @@ Buffer::~Buffer()
 
 void Buffer::Close()
 {
+  if (m_inputHandle.IsOpen())
+    LogReadStatistics();
+
   CloseHandle(m_inputHandle);
 }
 
@@ -43,3 +54,99 @@ void Buffer::CloseHandle(kodi::vfs::CFile& handle)
     handle.Close();
   }
 }
+
+int64_t Buffer::ResolveSeekPosition(int64_t position, int whence, int64_t windowStart) const
+{
+  int64_t newPosition;
+
+  switch (whence)
+  {
+    case SEEK_SET:
+      newPosition = position;
+      break;
+    case SEEK_CUR:
+      newPosition = Position() + position;
+      break;
+    case SEEK_END:
+      newPosition = Length() + position;
+      break;
+    default:
+      return -1;
+  }
+
+  // Stay within the data that is still available
+  return std::max(windowStart, std::min(newPosition, Length()));
+}
+
+void Buffer::RecordArrivalTime(int64_t position, int64_t windowStart)
+{
+  // Remember when each second's worth of data started
+  time_t now = time(nullptr);
+
+  if (m_arrivalTimes.empty() || m_arrivalTimes.back().second != now)
+    m_arrivalTimes.emplace_back(position, now);
+
+  // Forget about the data that has been overwritten, except for the entry
+  // that covers the start of the window
+  while (m_arrivalTimes.size() > 1 && m_arrivalTimes[1].first <= windowStart)
+    m_arrivalTimes.pop_front();
+}
+
+time_t Buffer::GetArrivalTime() const
+{
+  if (m_arrivalTimes.empty())
+    return m_startTime;
+
+  return m_arrivalTimes.front().second;
+}
+
+void Buffer::WaitForData(std::unique_lock<std::mutex>& lock, std::condition_variable& condition,
+                         int64_t position, size_t length)
+{
+  // In low-latency mode a few packets are enough, Kodi will come back for
+  // the rest
+  if (m_lowLatency)
+    length = std::min(length, LOW_LATENCY_READ_LENGTH);
+
+  int64_t requiredLength = position + length;
+  m_reads++;
+
+  if (Length() < requiredLength)
+  {
+    auto waitStart = std::chrono::steady_clock::now();
+    bool satisfied = condition.wait_for(lock, std::chrono::seconds(m_readTimeout),
+                                        [this, requiredLength]()
+                                        {
+                                          return Length() >= requiredLength;
+                                        });
+    auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - waitStart);
+
+    m_waits++;
+    m_totalWaitTime += waitTime;
+    m_longestWaitTime = std::max(m_longestWaitTime, waitTime);
+
+    if (!satisfied)
+      m_timeouts++;
+  }
+
+  // Remember how long it took until there was something to play
+  if (m_firstDataLatency.count() < 0 && Length() > position)
+  {
+    m_firstDataLatency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_openTime);
+  }
+}
+
+void Buffer::LogReadStatistics() const
+{
+  if (m_reads == 0)
+    return;
+
+  kodi::Log(ADDON_LOG_DEBUG,
+            "Timeshift buffer statistics: first data after %lld ms, %u reads, %u waited for data "
+            "(%u timed out), %lld ms spent waiting in total, longest wait %lld ms",
+            static_cast<long long>(m_firstDataLatency.count()), m_reads, m_waits, m_timeouts,
+            static_cast<long long>(m_totalWaitTime.count()),
+            static_cast<long long>(m_longestWaitTime.count()));
+}
@@ -8,8 +8,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <utility>
 
 /**
 * The basic type all buffers operate on
@@ -81,6 +86,12 @@ namespace timeshift
      */
     time_t GetStartTime() const { return m_startTime; }
 
+    /**
+     * @return the time of the oldest data in the buffer, which is when the
+     * buffering started unless the buffer has a limited size
+     */
+    virtual time_t GetWindowStartTime() const { return m_startTime; }
+
     /**
      * @return basically the current time
      */
@@ -92,8 +103,16 @@ namespace timeshift
      */
     void SetReadTimeout(int timeout) { m_readTimeout = timeout; }
 
+    /**
+     * Sets whether reads should return as soon as a few packets are
+     * available instead of waiting for the whole requested length
+     * @param lowLatency whether to enable low-latency reads
+     */
+    void SetLowLatency(bool lowLatency) { m_lowLatency = lowLatency; }
+
   protected:
     const static int DEFAULT_READ_TIMEOUT;
+    const static size_t LOW_LATENCY_READ_LENGTH;
 
     /**
      * Safely closes an open file handle.
@@ -101,6 +120,48 @@ namespace timeshift
      */
     void CloseHandle(kodi::vfs::CFile& handle);
 
+    /**
+     * Resolves the target of a seek relative to the current read position
+     * and length, and clamps it to the data that is still available
+     * @param position the position argument of the seek
+     * @param whence SEEK_SET, SEEK_CUR or SEEK_END
+     * @param windowStart the oldest position that can still be read
+     * @return the new position, or -1 if whence is invalid
+     */
+    int64_t ResolveSeekPosition(int64_t position, int whence, int64_t windowStart) const;
+
+    /**
+     * Waits until there is enough data to serve a read, or until the read
+     * timeout expires. In low-latency mode only LOW_LATENCY_READ_LENGTH
+     * bytes are waited for. Also keeps track of how long reads wait.
+     * @param lock a lock on the mutex the condition is used with
+     * @param condition signaled whenever new data has been added
+     * @param position the position the read starts at
+     * @param length the requested length
+     */
+    void WaitForData(std::unique_lock<std::mutex>& lock, std::condition_variable& condition,
+                     int64_t position, size_t length);
+
+    /**
+     * Remembers when the data that was just written arrived, so that the
+     * start time of the window can be reported once it starts sliding. Only
+     * needed by buffers with a limited size.
+     * @param position the stream position the written data starts at
+     * @param windowStart the oldest position that can still be read
+     */
+    void RecordArrivalTime(int64_t position, int64_t windowStart);
+
+    /**
+     * @return the time the oldest data still in the window arrived, or the
+     * start time if no arrival times have been recorded
+     */
+    time_t GetArrivalTime() const;
+
+    /**
+     * Forgets all recorded arrival times
+     */
+    void ClearArrivalTimes() { m_arrivalTimes.clear(); }
+
     /**
      * The input handle (where data is read from)
      */
@@ -112,10 +173,49 @@ namespace timeshift
      */
     int m_readTimeout = DEFAULT_READ_TIMEOUT;
 
+    /**
+     * Whether reads return as soon as a few packets are available
+     */
+    bool m_lowLatency = false;
+
   private:
+    /**
+     * Logs how long reads have been waiting for data since the buffer was
+     * opened
+     */
+    void LogReadStatistics() const;
+
     /**
      * The time the buffer was created
      */
     time_t m_startTime = 0;
+
+    /**
+     * The stream positions at which each second's worth of data begins, and
+     * the time that data arrived
+     */
+    std::deque<std::pair<int64_t, time_t>> m_arrivalTimes;
+
+    /**
+     * When the buffer was opened, used to determine how long it took until
+     * the first data could be read
+     */
+    std::chrono::steady_clock::time_point m_openTime;
+
+    /**
+     * How long it took from opening the buffer until the first data could
+     * be read, or a negative value if that hasn't happened yet
+     */
+    std::chrono::milliseconds m_firstDataLatency{-1};
+
+    /**
+     * Read statistics: how many reads there were, how many of them had to
+     * wait for data and how many gave up waiting, and how long they waited
+     */
+    unsigned int m_reads = 0;
+    unsigned int m_waits = 0;
+    unsigned int m_timeouts = 0;
+    std::chrono::milliseconds m_totalWaitTime{0};
+    std::chrono::milliseconds m_longestWaitTime{0};
   };
 } // namespace timeshift
@@ -8,14 +8,15 @@
 
 #include "FilesystemBuffer.h"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace timeshift;
 
 const int FilesystemBuffer::INPUT_READ_LENGTH = 32768;
 
-FilesystemBuffer::FilesystemBuffer(const std::string& bufferPath)
-  : Buffer(), m_readPosition(0), m_writePosition(0)
+FilesystemBuffer::FilesystemBuffer(const std::string& bufferPath, int64_t maxSize /* = 0 */)
+  : Buffer(), m_maxSize(std::max<int64_t>(maxSize, 0)), m_readPosition(0), m_writePosition(0), m_overwritePosition(0)
 {
   m_bufferPath = bufferPath + "/buffer.ts";
 }
@@ -56,6 +57,17 @@ void FilesystemBuffer::Close()
   Buffer::Close();
 }
 
+time_t FilesystemBuffer::GetWindowStartTime() const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // The oldest data may have been overwritten
+  if (m_maxSize == 0)
+    return Buffer::GetStartTime();
+
+  return GetArrivalTime();
+}
+
 void FilesystemBuffer::Reset()
 {
   // Close any open handles
@@ -68,32 +80,65 @@ void FilesystemBuffer::Reset()
     CloseHandle(m_outputWriteHandle);
 
   // Reset
-  m_readPosition = m_writePosition = 0;
+  m_readPosition = m_writePosition = m_overwritePosition = 0;
+  ClearArrivalTimes();
 }
 
 int FilesystemBuffer::Read(byte* buffer, size_t length)
 {
-  // Wait until we have enough data
-  int64_t requiredLength = Position() + length;
+  // Wait until we have enough data. The lock is only needed for waiting, the
+  // data itself is read without it so that a slow read never blocks ingest
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WaitForData(lock, m_condition, Position(), length);
+  }
 
-  std::unique_lock<std::mutex> lock(m_mutex);
-  m_condition.wait_for(lock, std::chrono::seconds(m_readTimeout),
-                       [this, requiredLength]()
-                       {
-                         return Length() >= requiredLength;
-                       });
+  int read = 0;
 
-  // Now we can read
-  int read = m_outputReadHandle.Read(buffer, length);
+  while (read < static_cast<int>(length))
+  {
+    // Skip ahead if the data at the read position has been overwritten
+    int64_t windowStart = GetWindowStart();
+
+    if (m_readPosition < windowStart)
+      m_readPosition = windowStart;
+
+    // Never read past what has been committed
+    int64_t position = Position();
+    int64_t offset = GetFileOffset(position);
+    int64_t chunk = std::min<int64_t>(static_cast<int64_t>(length) - read, Length() - position);
+
+    if (chunk <= 0)
+      break;
+
+    // Don't read across the end of the file when wrapping around
+    if (m_maxSize > 0)
+      chunk = std::min(chunk, m_maxSize - offset);
+
+    m_outputReadHandle.Seek(offset, SEEK_SET);
+    ssize_t bytesRead = m_outputReadHandle.Read(buffer + read, static_cast<size_t>(chunk));
+
+    if (bytesRead <= 0)
+      break;
+
+    // Discard the data if the writer wrapped around over it while we were
+    // reading it
+    if (position < GetWindowStart())
+      continue;
+
+    read += static_cast<int>(bytesRead);
+    m_readPosition += bytesRead;
+  }
 
-  m_readPosition += read;
   return read;
 }
 
 int64_t FilesystemBuffer::Seek(int64_t position, int whence)
 {
-  std::unique_lock<std::mutex> lock(m_mutex);
-  int64_t newPosition = m_outputReadHandle.Seek(position, whence);
+  int64_t newPosition = ResolveSeekPosition(position, whence, GetWindowStart());
+
+  if (newPosition < 0)
+    return -1;
 
   m_readPosition.exchange(newPosition);
   return newPosition;
@@ -108,10 +153,50 @@ void FilesystemBuffer::ConsumeInput()
     // Read from m_inputHandle
     ssize_t read = m_inputHandle.Read(buffer, INPUT_READ_LENGTH);
 
-    // Write to m_outputHandle
-    std::unique_lock<std::mutex> lock(m_mutex);
-    ssize_t written = m_outputWriteHandle.Write(buffer, read);
-    m_writePosition += written;
+    if (read <= 0)
+      continue;
+
+    // Write to m_outputHandle, wrapping around to the beginning of the file
+    // when the maximum size has been reached. The lock isn't held while
+    // writing, instead the reader is told which data is about to be
+    // overwritten before it is touched
+    const int64_t startPosition = Length();
+    int64_t writePosition = startPosition;
+    ssize_t written = 0;
+
+    m_overwritePosition = std::max(m_overwritePosition.load(), startPosition + read);
+
+    while (written < read)
+    {
+      int64_t offset = GetFileOffset(writePosition);
+      int64_t chunk = read - written;
+
+      if (m_maxSize > 0)
+      {
+        chunk = std::min(chunk, m_maxSize - offset);
+
+        if (offset == 0 && writePosition > 0)
+          m_outputWriteHandle.Seek(0, SEEK_SET);
+      }
+
+      ssize_t bytesWritten = m_outputWriteHandle.Write(buffer + written, static_cast<size_t>(chunk));
+
+      if (bytesWritten <= 0)
+        break;
+
+      written += bytesWritten;
+      writePosition += bytesWritten;
+    }
+
+    // Publish the new length. The lock is only taken so that a reader can't
+    // miss the notification between checking the length and waiting
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_writePosition = writePosition;
+
+      if (m_maxSize > 0)
+        RecordArrivalTime(startPosition, GetWindowStart());
+    }
 
     // Signal that we have data again
     m_condition.notify_one();
@@ -119,3 +204,16 @@ void FilesystemBuffer::ConsumeInput()
 
   delete[] buffer;
 }
+
+int64_t FilesystemBuffer::GetWindowStart() const
+{
+  if (m_maxSize == 0)
+    return 0;
+
+  return std::max<int64_t>(m_overwritePosition - m_maxSize, 0);
+}
+
+int64_t FilesystemBuffer::GetFileOffset(int64_t position) const
+{
+  return m_maxSize > 0 ? position % m_maxSize : position;
+}
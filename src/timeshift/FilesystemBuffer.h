@@ -28,8 +28,11 @@ namespace timeshift
   public:
     /**
      * @param bufferPath the directory to store the buffer files in
+     * @param maxSize the maximum size of the buffer file in bytes. When it is
+     * reached the buffer wraps around and the oldest data is overwritten.
+     * Zero means the buffer grows without limit
      */
-    FilesystemBuffer(const std::string& bufferPath);
+    FilesystemBuffer(const std::string& bufferPath, int64_t maxSize = 0);
     virtual ~FilesystemBuffer();
 
     virtual bool Open(const std::string inputUrl) override;
@@ -45,6 +48,8 @@ namespace timeshift
 
     virtual int64_t Length() const override { return m_writePosition.load(); }
 
+    virtual time_t GetWindowStartTime() const override;
+
   private:
     const static int INPUT_READ_LENGTH;
 
@@ -60,11 +65,28 @@ namespace timeshift
      */
     void Reset();
 
+    /**
+     * @return the oldest position that can still be read, taking the data
+     * that is currently being written into account
+     */
+    int64_t GetWindowStart() const;
+
+    /**
+     * @return the offset in the buffer file where the data at the specified
+     * stream position is stored
+     */
+    int64_t GetFileOffset(int64_t position) const;
+
     /**
      * The path to the buffer file
      */
     std::string m_bufferPath;
 
+    /**
+     * The maximum size of the buffer file, or zero if unlimited
+     */
+    int64_t m_maxSize;
+
     /**
      * Read-only handle to the buffer file
      */
@@ -87,7 +109,9 @@ namespace timeshift
     std::atomic<bool> m_active;
 
     /**
-     * Protects m_output*Handle
+     * Used to wait for new data and protects the arrival times. The output
+     * handles are only used by one thread each, so they are read from and
+     * written to without holding it
      */
     mutable std::mutex m_mutex;
 
@@ -97,13 +121,22 @@ namespace timeshift
     mutable std::condition_variable m_condition;
 
     /**
-     * The current read position in the buffer file
+     * The current read position in the stream
      */
     std::atomic<int64_t> m_readPosition;
 
     /**
-     * The current write position in the buffer file
+     * The current write position in the stream, i.e. the total amount of
+     * data that has been committed to the buffer file. Only the last
+     * m_maxSize bytes are kept when the buffer is bounded
      */
     std::atomic<int64_t> m_writePosition;
+
+    /**
+     * The end of the data that is currently being written. In a bounded
+     * buffer the data up to m_maxSize bytes before this position may be in
+     * the process of being overwritten
+     */
+    std::atomic<int64_t> m_overwritePosition;
   };
 } // namespace timeshift
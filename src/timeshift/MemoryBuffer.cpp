@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "MemoryBuffer.h"
+
+#include <algorithm>
+
+using namespace timeshift;
+
+const int MemoryBuffer::INPUT_READ_LENGTH = 32768;
+
+MemoryBuffer::MemoryBuffer(size_t size)
+  : Buffer(), m_ring(std::max<size_t>(size, INPUT_READ_LENGTH)), m_active(false), m_readPosition(0), m_writePosition(0)
+{
+}
+
+MemoryBuffer::~MemoryBuffer()
+{
+  MemoryBuffer::Close();
+}
+
+bool MemoryBuffer::Open(const std::string inputUrl)
+{
+  // Allocate the ring up front so that ingest never has to allocate
+  if (!m_ring.Allocate() || !Buffer::Open(inputUrl))
+    return false;
+
+  // Start the input thread
+  m_active = true;
+  m_inputThread = std::thread([this]() { ConsumeInput(); });
+
+  return true;
+}
+
+void MemoryBuffer::Close()
+{
+  // Wait for the input thread to terminate
+  m_active = false;
+
+  if (m_inputThread.joinable())
+    m_inputThread.join();
+
+  Reset();
+  Buffer::Close();
+}
+
+time_t MemoryBuffer::GetWindowStartTime() const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return GetArrivalTime();
+}
+
+void MemoryBuffer::Reset()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_readPosition = m_writePosition = 0;
+  ClearArrivalTimes();
+}
+
+int MemoryBuffer::Read(byte* buffer, size_t length)
+{
+  // Wait until we have enough data
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForData(lock, m_condition, Position(), length);
+
+  // Skip ahead if the data at the read position has been overwritten
+  if (m_readPosition < GetWindowStart())
+    m_readPosition = GetWindowStart();
+
+  // Copy what we have
+  int64_t position = Position();
+  size_t available = static_cast<size_t>(std::min<int64_t>(static_cast<int64_t>(length), Length() - position));
+  m_ring.Read(position, buffer, available);
+
+  m_readPosition += available;
+  return static_cast<int>(available);
+}
+
+int64_t MemoryBuffer::Seek(int64_t position, int whence)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  int64_t newPosition = ResolveSeekPosition(position, whence, GetWindowStart());
+
+  if (newPosition < 0)
+    return -1;
+
+  m_readPosition.exchange(newPosition);
+  return newPosition;
+}
+
+void MemoryBuffer::ConsumeInput()
+{
+  byte* buffer = new byte[INPUT_READ_LENGTH];
+
+  while (m_active)
+  {
+    // Read from m_inputHandle
+    ssize_t read = m_inputHandle.Read(buffer, INPUT_READ_LENGTH);
+
+    if (read <= 0)
+      continue;
+
+    // Copy into the ring, overwriting the oldest data once it is full
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const int64_t startPosition = Length();
+    m_ring.Write(startPosition, buffer, static_cast<size_t>(read));
+
+    m_writePosition += read;
+    RecordArrivalTime(startPosition, GetWindowStart());
+
+    // Signal that we have data again
+    m_condition.notify_one();
+  }
+
+  delete[] buffer;
+}
+
+int64_t MemoryBuffer::GetWindowStart() const
+{
+  return std::max<int64_t>(Length() - static_cast<int64_t>(m_ring.GetSize()), 0);
+}
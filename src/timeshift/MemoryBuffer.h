@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "Buffer.h"
+#include "MemoryRing.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace timeshift
+{
+
+  /**
+   * Timeshift buffer which buffers into a fixed-size ring in memory. Once
+   * the ring is full the oldest data is overwritten, so only the most recent
+   * "size" bytes can be sought to.
+   */
+  class ATTR_DLL_LOCAL MemoryBuffer : public Buffer
+  {
+  public:
+    /**
+     * @param size the size of the ring in bytes
+     */
+    explicit MemoryBuffer(size_t size);
+    virtual ~MemoryBuffer();
+
+    virtual bool Open(const std::string inputUrl) override;
+    virtual void Close() override;
+    virtual int Read(byte* buffer, size_t length) override;
+    virtual int64_t Seek(int64_t position, int whence) override;
+
+    virtual bool CanPauseStream() const override { return true; }
+
+    virtual bool CanSeekStream() const override { return true; }
+
+    virtual int64_t Position() const override { return m_readPosition.load(); }
+
+    virtual int64_t Length() const override { return m_writePosition.load(); }
+
+    virtual time_t GetWindowStartTime() const override;
+
+  private:
+    const static int INPUT_READ_LENGTH;
+
+    /**
+     * The method that runs on m_inputThread. It reads data from the input
+     * handle and copies it into the ring
+     */
+    void ConsumeInput();
+
+    /**
+     * Resets all positions
+     */
+    void Reset();
+
+    /**
+     * @return the oldest position that can still be read
+     */
+    int64_t GetWindowStart() const;
+
+    /**
+     * The ring itself. It is allocated when the buffer is first opened and
+     * then reused for every subsequent stream
+     */
+    MemoryRing m_ring;
+
+    /**
+     * The thread that reads from m_inputHandle and writes to the ring
+     */
+    std::thread m_inputThread;
+
+    /**
+     * Whether the buffer is active, i.e. m_inputHandle should be read from
+     */
+    std::atomic<bool> m_active;
+
+    /**
+     * Protects m_ring
+     */
+    mutable std::mutex m_mutex;
+
+    /**
+     * Signaled whenever new data has been added to the buffer
+     */
+    mutable std::condition_variable m_condition;
+
+    /**
+     * The current read position in the stream
+     */
+    std::atomic<int64_t> m_readPosition;
+
+    /**
+     * The current write position in the stream, i.e. the total amount of
+     * data written. Only the most recent data that fits are kept in the ring
+     */
+    std::atomic<int64_t> m_writePosition;
+  };
+} // namespace timeshift
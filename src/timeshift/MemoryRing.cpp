@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "MemoryRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+using namespace timeshift;
+
+MemoryRing::MemoryRing(size_t size) : m_size(size)
+{
+}
+
+bool MemoryRing::Allocate()
+{
+  if (m_data.size() == m_size)
+    return true;
+
+  try
+  {
+    m_data.resize(m_size);
+  }
+  catch (const std::bad_alloc&)
+  {
+    kodi::Log(ADDON_LOG_ERROR, "Failed to allocate %u MB for the timeshift buffer",
+              static_cast<unsigned int>(m_size / 1024 / 1024));
+    return false;
+  }
+  catch (const std::length_error&)
+  {
+    kodi::Log(ADDON_LOG_ERROR, "A timeshift buffer of %u MB is too large for this system",
+              static_cast<unsigned int>(m_size / 1024 / 1024));
+    return false;
+  }
+
+  return true;
+}
+
+void MemoryRing::Write(int64_t position, const byte* data, size_t length)
+{
+  size_t offset = static_cast<size_t>(position % static_cast<int64_t>(m_size));
+  size_t firstChunk = std::min(length, m_size - offset);
+
+  std::memcpy(m_data.data() + offset, data, firstChunk);
+  std::memcpy(m_data.data(), data + firstChunk, length - firstChunk);
+}
+
+void MemoryRing::Read(int64_t position, byte* data, size_t length) const
+{
+  size_t offset = static_cast<size_t>(position % static_cast<int64_t>(m_size));
+  size_t firstChunk = std::min(length, m_size - offset);
+
+  std::memcpy(data, m_data.data() + offset, firstChunk);
+  std::memcpy(data + firstChunk, m_data.data(), length - firstChunk);
+}
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "Buffer.h"
+
+#include <vector>
+
+namespace timeshift
+{
+
+  /**
+   * A fixed-size ring of bytes addressed by stream position. The data at a
+   * position is stored at "position % size", so writing past the end wraps
+   * around and overwrites the oldest data. Not thread-safe, the owning
+   * buffer is responsible for locking.
+   */
+  class ATTR_DLL_LOCAL MemoryRing
+  {
+  public:
+    /**
+     * @param size the size of the ring in bytes
+     */
+    explicit MemoryRing(size_t size);
+
+    /**
+     * Allocates the ring unless it already has been, so that ingest never
+     * has to allocate
+     * @return whether the ring could be allocated
+     */
+    bool Allocate();
+
+    /**
+     * @return the size of the ring in bytes
+     */
+    size_t GetSize() const { return m_size; }
+
+    /**
+     * Copies data into the ring, splitting the copy where the ring wraps
+     * around
+     * @param position the stream position of the data
+     * @param data the data
+     * @param length the length of the data, at most the size of the ring
+     */
+    void Write(int64_t position, const byte* data, size_t length);
+
+    /**
+     * Copies data out of the ring. The caller must make sure the range
+     * hasn't been overwritten yet
+     * @param position the stream position to start at
+     * @param data where to copy the data
+     * @param length the amount of data to copy
+     */
+    void Read(int64_t position, byte* data, size_t length) const;
+
+  private:
+    /**
+     * The size of the ring
+     */
+    size_t m_size;
+
+    /**
+     * The ring itself. It is allocated by Allocate() and then reused for
+     * every subsequent stream
+     */
+    std::vector<byte> m_data;
+  };
+} // namespace timeshift
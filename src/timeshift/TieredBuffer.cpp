@@ -0,0 +1,330 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "TieredBuffer.h"
+
+#include <algorithm>
+
+using namespace timeshift;
+
+const int TieredBuffer::INPUT_READ_LENGTH = 32768;
+const int TieredBuffer::SPILL_LENGTH = 262144;
+
+TieredBuffer::TieredBuffer(const std::string& bufferPath, size_t memorySize, int64_t maxDiskSize /* = 0 */)
+  : Buffer(),
+    m_maxDiskSize(std::max<int64_t>(maxDiskSize, 0)),
+    m_memory(std::max<size_t>(memorySize, SPILL_LENGTH)),
+    m_active(false),
+    m_readPosition(0),
+    m_writePosition(0),
+    m_spilledPosition(0),
+    m_spillingPosition(0),
+    m_spillFailed(false)
+{
+  m_bufferPath = bufferPath + "/buffer.ts";
+}
+
+TieredBuffer::~TieredBuffer()
+{
+  TieredBuffer::Close();
+
+  // Remove the buffer file so it doesn't take up space once Kodi has exited
+  kodi::vfs::DeleteFile(m_bufferPath);
+}
+
+bool TieredBuffer::Open(const std::string inputUrl)
+{
+  // Allocate the ring up front so that ingest never has to allocate
+  if (!m_memory.Allocate())
+    return false;
+
+  // Open the file handles
+  m_diskWriteHandle.OpenFileForWrite(m_bufferPath, true);
+  m_diskReadHandle.OpenFile(m_bufferPath, ADDON_READ_NO_CACHE);
+
+  if (!Buffer::Open(inputUrl) || !m_diskReadHandle.IsOpen() || !m_diskWriteHandle.IsOpen())
+    return false;
+
+  // Start the input and spill threads
+  m_active = true;
+  m_inputThread = std::thread([this]() { ConsumeInput(); });
+  m_spillThread = std::thread([this]() { SpillToDisk(); });
+
+  return true;
+}
+
+void TieredBuffer::Close()
+{
+  // Wake up any thread that is waiting and wait for them to terminate
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_active = false;
+    m_condition.notify_all();
+    m_spillCondition.notify_all();
+  }
+
+  if (m_inputThread.joinable())
+    m_inputThread.join();
+
+  if (m_spillThread.joinable())
+    m_spillThread.join();
+
+  Reset();
+  Buffer::Close();
+}
+
+time_t TieredBuffer::GetWindowStartTime() const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // The oldest data may have been overwritten
+  if (m_maxDiskSize == 0 && !m_spillFailed)
+    return Buffer::GetStartTime();
+
+  return GetArrivalTime();
+}
+
+void TieredBuffer::Reset()
+{
+  // Close any open handles
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  if (m_diskReadHandle.IsOpen())
+    CloseHandle(m_diskReadHandle);
+
+  if (m_diskWriteHandle.IsOpen())
+    CloseHandle(m_diskWriteHandle);
+
+  // Reset
+  m_readPosition = m_writePosition = 0;
+  m_spilledPosition = m_spillingPosition = 0;
+  m_spillFailed = false;
+  ClearArrivalTimes();
+}
+
+int TieredBuffer::Read(byte* buffer, size_t length)
+{
+  // Wait until we have enough data
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForData(lock, m_condition, Position(), length);
+
+  int read = 0;
+
+  while (read < static_cast<int>(length))
+  {
+    // Skip ahead if the data at the read position has been overwritten
+    if (m_readPosition < GetWindowStart())
+      m_readPosition = GetWindowStart();
+
+    int64_t position = Position();
+    int64_t available = std::min<int64_t>(static_cast<int64_t>(length) - read, Length() - position);
+
+    if (available <= 0)
+      break;
+
+    // Serve the read from memory when possible
+    int64_t memoryWindowStart = GetMemoryWindowStart();
+
+    if (position >= memoryWindowStart)
+    {
+      m_memory.Read(position, buffer + read, static_cast<size_t>(available));
+      read += static_cast<int>(available);
+      m_readPosition += available;
+      break;
+    }
+
+    // Older data has to come from disk. The data before the ring has always
+    // been spilled, so only the file can overwrite it while we're reading
+    size_t chunk = static_cast<size_t>(std::min(available, memoryWindowStart - position));
+
+    lock.unlock();
+    int bytesRead = ReadFromDisk(position, buffer + read, chunk);
+    lock.lock();
+
+    if (bytesRead <= 0)
+      break;
+
+    // Discard the data if the spill thread wrapped around over it meanwhile
+    if (position < GetDiskWindowStart())
+      continue;
+
+    read += bytesRead;
+    m_readPosition += bytesRead;
+  }
+
+  return read;
+}
+
+int64_t TieredBuffer::Seek(int64_t position, int whence)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  int64_t newPosition = ResolveSeekPosition(position, whence, GetWindowStart());
+
+  if (newPosition < 0)
+    return -1;
+
+  m_readPosition.exchange(newPosition);
+  return newPosition;
+}
+
+void TieredBuffer::ConsumeInput()
+{
+  byte* buffer = new byte[INPUT_READ_LENGTH];
+
+  while (m_active)
+  {
+    // Read from m_inputHandle
+    ssize_t read = m_inputHandle.Read(buffer, INPUT_READ_LENGTH);
+
+    if (read <= 0)
+      continue;
+
+    // Data that hasn't been spilled yet must not be overwritten, so wait for
+    // the spill thread if the disk can't keep up. Once spilling has failed
+    // the ring is all there is, so the oldest data is overwritten instead
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto hasRoom = [this, read]()
+    {
+      return !m_active || m_spillFailed ||
+             Length() + read - m_spilledPosition <= static_cast<int64_t>(m_memory.GetSize());
+    };
+
+    if (!hasRoom())
+    {
+      kodi::Log(ADDON_LOG_DEBUG, "Timeshift buffer is waiting for the disk to catch up");
+      m_spillCondition.wait(lock, hasRoom);
+
+      if (!m_active)
+        break;
+    }
+
+    // Copy into the ring, overwriting data that has already been spilled
+    const int64_t startPosition = Length();
+    m_memory.Write(startPosition, buffer, static_cast<size_t>(read));
+
+    m_writePosition += read;
+
+    if (m_maxDiskSize > 0 || m_spillFailed)
+      RecordArrivalTime(startPosition, GetWindowStart());
+
+    // Signal that we have data again
+    m_condition.notify_all();
+  }
+
+  delete[] buffer;
+}
+
+void TieredBuffer::SpillToDisk()
+{
+  byte* buffer = new byte[SPILL_LENGTH];
+
+  while (m_active)
+  {
+    // Wait for data that hasn't been spilled yet
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return !m_active || m_spilledPosition < Length(); });
+
+    if (!m_active)
+      break;
+
+    // Copy a chunk out of the ring, never across the end of the file
+    int64_t position = m_spilledPosition;
+    int64_t chunk = std::min<int64_t>(SPILL_LENGTH, Length() - position);
+    int64_t offset = GetFileOffset(position);
+
+    if (m_maxDiskSize > 0)
+      chunk = std::min(chunk, m_maxDiskSize - offset);
+
+    m_memory.Read(position, buffer, static_cast<size_t>(chunk));
+    m_spillingPosition = position + chunk;
+    lock.unlock();
+
+    // Write it without blocking the input thread or the reader
+    m_diskWriteHandle.Seek(offset, SEEK_SET);
+    ssize_t written = 0;
+
+    while (written < chunk)
+    {
+      ssize_t bytesWritten = m_diskWriteHandle.Write(buffer + written, static_cast<size_t>(chunk - written));
+
+      if (bytesWritten <= 0)
+        break;
+
+      written += bytesWritten;
+    }
+
+    lock.lock();
+
+    // Keep buffering in memory only rather than stopping playback
+    if (written < chunk)
+    {
+      kodi::Log(ADDON_LOG_ERROR, "Failed to write to the timeshift buffer file %s, only buffering in memory from now on",
+                m_bufferPath.c_str());
+      m_spillFailed = true;
+      m_spillCondition.notify_all();
+      break;
+    }
+
+    m_spilledPosition = position + chunk;
+    m_spillCondition.notify_all();
+  }
+
+  delete[] buffer;
+}
+
+int64_t TieredBuffer::GetWindowStart() const
+{
+  return std::min(GetMemoryWindowStart(), GetDiskWindowStart());
+}
+
+int64_t TieredBuffer::GetMemoryWindowStart() const
+{
+  return std::max<int64_t>(Length() - static_cast<int64_t>(m_memory.GetSize()), 0);
+}
+
+int64_t TieredBuffer::GetDiskWindowStart() const
+{
+  // Nothing is read from the buffer file once spilling has failed
+  if (m_spillFailed)
+    return Length();
+
+  if (m_maxDiskSize == 0)
+    return 0;
+
+  return std::max<int64_t>(m_spillingPosition - m_maxDiskSize, 0);
+}
+
+int64_t TieredBuffer::GetFileOffset(int64_t position) const
+{
+  return m_maxDiskSize > 0 ? position % m_maxDiskSize : position;
+}
+
+int TieredBuffer::ReadFromDisk(int64_t position, byte* buffer, size_t length)
+{
+  int read = 0;
+
+  while (read < static_cast<int>(length))
+  {
+    int64_t offset = GetFileOffset(position + read);
+    int64_t chunk = static_cast<int64_t>(length) - read;
+
+    // Don't read across the end of the file when wrapping around
+    if (m_maxDiskSize > 0)
+      chunk = std::min(chunk, m_maxDiskSize - offset);
+
+    m_diskReadHandle.Seek(offset, SEEK_SET);
+    ssize_t bytesRead = m_diskReadHandle.Read(buffer + read, static_cast<size_t>(chunk));
+
+    if (bytesRead <= 0)
+      break;
+
+    read += static_cast<int>(bytesRead);
+  }
+
+  return read;
+}
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "Buffer.h"
+#include "MemoryRing.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <kodi/Filesystem.h>
+
+namespace timeshift
+{
+
+  /**
+   * Timeshift buffer which keeps the most recent data in a RAM ring and
+   * spills everything to a file in the background. Reads close to the live
+   * edge are served from memory while older data is read back from disk, so
+   * the pause window is only limited by the size of the file.
+   */
+  class ATTR_DLL_LOCAL TieredBuffer : public Buffer
+  {
+  public:
+    /**
+     * @param bufferPath the directory to store the buffer file in
+     * @param memorySize the size of the RAM ring in bytes
+     * @param maxDiskSize the maximum size of the buffer file in bytes. When
+     * it is reached the file wraps around and the oldest data is
+     * overwritten. Zero means the file grows without limit
+     */
+    TieredBuffer(const std::string& bufferPath, size_t memorySize, int64_t maxDiskSize = 0);
+    virtual ~TieredBuffer();
+
+    virtual bool Open(const std::string inputUrl) override;
+    virtual void Close() override;
+    virtual int Read(byte* buffer, size_t length) override;
+    virtual int64_t Seek(int64_t position, int whence) override;
+
+    virtual bool CanPauseStream() const override { return true; }
+
+    virtual bool CanSeekStream() const override { return true; }
+
+    virtual int64_t Position() const override { return m_readPosition.load(); }
+
+    virtual int64_t Length() const override { return m_writePosition.load(); }
+
+    virtual time_t GetWindowStartTime() const override;
+
+  private:
+    const static int INPUT_READ_LENGTH;
+    const static int SPILL_LENGTH;
+
+    /**
+     * The method that runs on m_inputThread. It reads data from the input
+     * handle and copies it into the ring
+     */
+    void ConsumeInput();
+
+    /**
+     * The method that runs on m_spillThread. It copies data from the ring
+     * to the buffer file
+     */
+    void SpillToDisk();
+
+    /**
+     * Closes any open file handles and resets all positions
+     */
+    void Reset();
+
+    /**
+     * @return the oldest position that can still be read from either tier
+     */
+    int64_t GetWindowStart() const;
+
+    /**
+     * @return the oldest position that is still in the ring
+     */
+    int64_t GetMemoryWindowStart() const;
+
+    /**
+     * @return the oldest position that is still in the buffer file, taking
+     * the data that is currently being spilled into account. No data is
+     * available from the file once spilling has failed
+     */
+    int64_t GetDiskWindowStart() const;
+
+    /**
+     * @return the offset in the buffer file where the data at the specified
+     * stream position is stored
+     */
+    int64_t GetFileOffset(int64_t position) const;
+
+    /**
+     * Reads data from the buffer file without holding m_mutex
+     * @return the number of bytes read
+     */
+    int ReadFromDisk(int64_t position, byte* buffer, size_t length);
+
+    /**
+     * The path to the buffer file
+     */
+    std::string m_bufferPath;
+
+    /**
+     * The maximum size of the buffer file, or zero if unlimited
+     */
+    int64_t m_maxDiskSize;
+
+    /**
+     * The ring. It is allocated when the buffer is first opened and then
+     * reused for every subsequent stream
+     */
+    MemoryRing m_memory;
+
+    /**
+     * Read-only handle to the buffer file, only used by the reader
+     */
+    kodi::vfs::CFile m_diskReadHandle;
+
+    /**
+     * Write-only handle to the buffer file, only used by m_spillThread
+     */
+    kodi::vfs::CFile m_diskWriteHandle;
+
+    /**
+     * The thread that reads from m_inputHandle and writes to the ring
+     */
+    std::thread m_inputThread;
+
+    /**
+     * The thread that copies data from the ring to the buffer file
+     */
+    std::thread m_spillThread;
+
+    /**
+     * Whether the buffer is active, i.e. m_inputHandle should be read from
+     */
+    std::atomic<bool> m_active;
+
+    /**
+     * Protects m_memory and the positions below
+     */
+    mutable std::mutex m_mutex;
+
+    /**
+     * Signaled whenever new data has been added to the ring
+     */
+    mutable std::condition_variable m_condition;
+
+    /**
+     * Signaled whenever data has been spilled to disk
+     */
+    std::condition_variable m_spillCondition;
+
+    /**
+     * The current read position in the stream
+     */
+    std::atomic<int64_t> m_readPosition;
+
+    /**
+     * The current write position in the stream, i.e. the total amount of
+     * data written to the ring
+     */
+    std::atomic<int64_t> m_writePosition;
+
+    /**
+     * Everything before this position has been written to the buffer file
+     */
+    int64_t m_spilledPosition;
+
+    /**
+     * The end of the data that is currently being written to the buffer
+     * file. Data this far back in the file may be in the process of being
+     * overwritten
+     */
+    int64_t m_spillingPosition;
+
+    /**
+     * Whether writing to the buffer file has failed. From then on the
+     * buffer only uses the ring
+     */
+    bool m_spillFailed;
+  };
+} // namespace timeshift
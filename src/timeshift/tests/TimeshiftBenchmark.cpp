@@ -0,0 +1,265 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "../FilesystemBuffer.h"
+#include "../MemoryBuffer.h"
+#include "../TieredBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace timeshift;
+
+namespace
+{
+  const int64_t DEFAULT_BITRATE = 20;
+  const int DEFAULT_PAUSE_LENGTH = 10;
+  const int LIVE_LENGTH = 3;
+  const size_t MEMORY_SIZE = 8 * 1024 * 1024;
+  const size_t GENERATED_INPUT_SIZE = 16 * 1024 * 1024;
+  const size_t READ_LENGTH = 32768;
+  const size_t TS_PACKET_LENGTH = 188;
+
+  struct Result
+  {
+    double firstDataLatency = 0;
+    std::vector<double> readLatencies;
+    int64_t bytesCaughtUp = 0;
+    double catchUpTime = 0; // Time spent in Read() only, not verifying
+    int errors = 0;
+  };
+
+  double GetElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /**
+   * Writes a file of TS packets with a continuity counter and pseudo-random
+   * payload
+   * @return the contents of the file, or an empty vector on failure
+   */
+  std::vector<byte> GenerateInput(const std::string& path)
+  {
+    std::vector<byte> input(GENERATED_INPUT_SIZE - GENERATED_INPUT_SIZE % TS_PACKET_LENGTH);
+    unsigned int seed = 20210101;
+
+    for (size_t i = 0; i < input.size(); i += TS_PACKET_LENGTH)
+    {
+      input[i] = 0x47;
+      input[i + 1] = 0x01;
+      input[i + 2] = 0x00;
+      input[i + 3] = 0x10 | ((i / TS_PACKET_LENGTH) & 0x0f);
+
+      for (size_t j = 4; j < TS_PACKET_LENGTH; j++)
+      {
+        seed = seed * 1103515245 + 12345;
+        input[i + j] = static_cast<byte>(seed >> 16);
+      }
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+      return {};
+
+    bool written = std::fwrite(input.data(), 1, input.size(), file) == input.size();
+    std::fclose(file);
+
+    return written ? input : std::vector<byte>();
+  }
+
+  /**
+   * @return the contents of the file, or an empty vector on failure
+   */
+  std::vector<byte> LoadInput(const std::string& path)
+  {
+    std::vector<byte> input;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+      return input;
+
+    byte chunk[65536];
+    size_t read;
+
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+      input.insert(input.end(), chunk, chunk + read);
+
+    std::fclose(file);
+    return input;
+  }
+
+  /**
+   * Checks that the data read ends at the current read position and
+   * matches the input, which is looped
+   * @return whether the data is correct
+   */
+  bool Verify(const Buffer& buffer, const std::vector<byte>& input, const byte* data, int length)
+  {
+    int64_t start = buffer.Position() - length;
+
+    for (int i = 0; i < length; i++)
+    {
+      if (data[i] != input[static_cast<size_t>((start + i) % static_cast<int64_t>(input.size()))])
+        return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Watches live for LIVE_LENGTH seconds, pauses for pauseLength seconds
+   * and then reads as fast as possible until the live edge is reached
+   * again, the way a user catching up with fast-forward would
+   */
+  Result Run(Buffer& buffer, const std::string& inputUrl, const std::vector<byte>& input, int pauseLength)
+  {
+    Result result;
+    std::vector<byte> data(READ_LENGTH);
+
+    auto start = std::chrono::steady_clock::now();
+    if (!buffer.Open(inputUrl))
+    {
+      std::fprintf(stderr, "Failed to open the buffer\n");
+      result.errors++;
+      return result;
+    }
+
+    // The time until the player receives the first data
+    int read = buffer.Read(data.data(), data.size());
+    result.firstDataLatency = GetElapsedMilliseconds(start);
+
+    if (read <= 0 || !Verify(buffer, input, data.data(), read))
+      result.errors++;
+
+    // Watch live
+    start = std::chrono::steady_clock::now();
+    while (GetElapsedMilliseconds(start) < LIVE_LENGTH * 1000)
+    {
+      auto readStart = std::chrono::steady_clock::now();
+      read = buffer.Read(data.data(), data.size());
+      result.readLatencies.push_back(GetElapsedMilliseconds(readStart));
+
+      if (read <= 0 || !Verify(buffer, input, data.data(), read))
+        result.errors++;
+    }
+
+    // Pause, then catch up. Only the data that is still buffered is read,
+    // a buffer that is too small skips ahead
+    std::this_thread::sleep_for(std::chrono::seconds(pauseLength));
+
+    while (buffer.Length() - buffer.Position() > static_cast<int64_t>(READ_LENGTH))
+    {
+      auto readStart = std::chrono::steady_clock::now();
+      read = buffer.Read(data.data(), data.size());
+      result.catchUpTime += GetElapsedMilliseconds(readStart);
+
+      if (read <= 0 || !Verify(buffer, input, data.data(), read))
+      {
+        result.errors++;
+        break;
+      }
+
+      result.bytesCaughtUp += read;
+    }
+
+    buffer.Close();
+    return result;
+  }
+
+  void PrintResult(const char* name, Result& result)
+  {
+    auto& latencies = result.readLatencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    double average = 0;
+    for (double latency : latencies)
+      average += latency;
+
+    if (!latencies.empty())
+      average /= latencies.size();
+
+    double p99 = latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100];
+    double max = latencies.empty() ? 0 : latencies.back();
+    double caughtUp = result.bytesCaughtUp / 1024.0 / 1024.0;
+
+    std::printf("  %-30s %8.1f ms %8.2f %8.2f %8.2f ms %7.1f MB %9.1f MB/s %4d\n", name, result.firstDataLatency,
+                average, p99, max, caughtUp, caughtUp * 1000 / std::max(result.catchUpTime, 0.001),
+                result.errors);
+  }
+} // unnamed namespace
+
+/**
+ * Compares the timeshift buffers when fed from a local file at a fixed
+ * bitrate. Reports how long it takes until the first data can be read, how
+ * long reads take while watching live, and how fast the buffered data can
+ * be read back after pausing.
+ *
+ * Usage: timeshift_benchmark <buffer directory> [input file] [bitrate in
+ * Mbit/s] [pause length in seconds]. Without an input file a file of
+ * generated TS packets is used.
+ */
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::fprintf(stderr, "Usage: %s <buffer directory> [input file] [bitrate in Mbit/s] [pause length in seconds]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  std::string bufferPath = argv[1];
+  std::string inputPath = argc > 2 ? argv[2] : bufferPath + "/input.ts";
+  int64_t bitrate = argc > 3 ? std::atoll(argv[3]) : DEFAULT_BITRATE;
+  int pauseLength = argc > 4 ? std::atoi(argv[4]) : DEFAULT_PAUSE_LENGTH;
+
+  std::vector<byte> input = argc > 2 ? LoadInput(inputPath) : GenerateInput(inputPath);
+  if (input.empty())
+  {
+    std::fprintf(stderr, "Failed to %s the input file %s\n", argc > 2 ? "read" : "write", inputPath.c_str());
+    return 1;
+  }
+
+  kodi::vfs::SetInputBitrate(bitrate * 1000 * 1000);
+  std::string inputUrl = "file://" + inputPath;
+
+  std::printf("%lld Mbit/s from %s, %d s live, %d s pause, %zu MB memory buffer\n", static_cast<long long>(bitrate),
+              inputPath.c_str(), LIVE_LENGTH, pauseLength, MEMORY_SIZE / 1024 / 1024);
+  std::printf("  %-30s %11s %28s %22s %9s\n", "buffer", "first data", "live read avg/p99/max", "catch-up",
+              "errors");
+
+  int errors = 0;
+
+  for (bool lowLatency : {false, true})
+  {
+    std::vector<std::pair<std::string, std::unique_ptr<Buffer>>> buffers;
+    buffers.emplace_back("disk", std::unique_ptr<Buffer>(new FilesystemBuffer(bufferPath)));
+    buffers.emplace_back("memory", std::unique_ptr<Buffer>(new MemoryBuffer(MEMORY_SIZE)));
+    buffers.emplace_back("memory and disk", std::unique_ptr<Buffer>(new TieredBuffer(bufferPath, MEMORY_SIZE)));
+
+    for (auto& buffer : buffers)
+    {
+      std::string name = buffer.first + (lowLatency ? " (low latency)" : "");
+      buffer.second->SetLowLatency(lowLatency);
+
+      Result result = Run(*buffer.second, inputUrl, input, pauseLength);
+      PrintResult(name.c_str(), result);
+      errors += result.errors;
+    }
+  }
+
+  if (argc <= 2)
+    kodi::vfs::DeleteFile(inputPath);
+
+  return errors == 0 ? 0 : 1;
+}
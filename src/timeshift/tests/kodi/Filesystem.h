@@ -0,0 +1,168 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+/*
+ * A POSIX implementation of the few parts of the Kodi add-on API that the
+ * timeshift buffers use, so that they can be benchmarked outside of Kodi. It
+ * takes the place of the real <kodi/Filesystem.h> for the benchmark only.
+ *
+ * Inputs opened with a file:// URL behave like a live stream: they are
+ * delivered at the bitrate set with SetInputBitrate() and start over from the
+ * beginning when the end of the file has been reached.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define ATTR_DLL_LOCAL
+
+typedef enum ADDON_LOG
+{
+  ADDON_LOG_DEBUG = 0,
+  ADDON_LOG_INFO = 1,
+  ADDON_LOG_WARNING = 2,
+  ADDON_LOG_ERROR = 3,
+  ADDON_LOG_FATAL = 4
+} ADDON_LOG;
+
+#define ADDON_READ_NO_CACHE 0x08
+
+namespace kodi
+{
+  inline void Log(const ADDON_LOG level, const char* format, ...)
+  {
+    static const char* levels[] = {"debug", "info", "warning", "error", "fatal"};
+
+    va_list args;
+    va_start(args, format);
+    std::fprintf(stderr, "[%s] ", levels[level]);
+    std::vfprintf(stderr, format, args);
+    std::fprintf(stderr, "\n");
+    va_end(args);
+  }
+
+  namespace vfs
+  {
+    /**
+     * The bitrate file:// inputs are delivered at, in bits per second
+     */
+    inline int64_t& InputBitrate()
+    {
+      static int64_t bitrate = 0;
+      return bitrate;
+    }
+
+    inline void SetInputBitrate(int64_t bitrate) { InputBitrate() = bitrate; }
+
+    inline bool DeleteFile(const std::string& filename) { return ::unlink(filename.c_str()) == 0; }
+
+    class CFile
+    {
+    public:
+      CFile() = default;
+      ~CFile() { Close(); }
+
+      CFile(const CFile&) = delete;
+      CFile& operator=(const CFile&) = delete;
+
+      bool OpenFile(const std::string& filename, unsigned int /* flags */ = 0)
+      {
+        Close();
+
+        // Strip the protocol options
+        std::string path = filename.substr(0, filename.find('|'));
+
+        m_live = path.compare(0, 7, "file://") == 0;
+        if (m_live)
+          path = path.substr(7);
+
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        m_openTime = std::chrono::steady_clock::now();
+        m_delivered = 0;
+
+        return m_fd >= 0;
+      }
+
+      bool OpenFileForWrite(const std::string& filename, bool overwrite = false)
+      {
+        Close();
+
+        m_live = false;
+        m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | (overwrite ? O_TRUNC : 0), 0644);
+
+        return m_fd >= 0;
+      }
+
+      bool IsOpen() const { return m_fd >= 0; }
+
+      void Close()
+      {
+        if (m_fd >= 0)
+          ::close(m_fd);
+
+        m_fd = -1;
+      }
+
+      ssize_t Read(void* ptr, size_t size)
+      {
+        if (!m_live)
+          return ::read(m_fd, ptr, size);
+
+        // Wait until at least one datagram's worth of data is due, then hand
+        // out everything that is
+        const int64_t bytesPerSecond = std::max<int64_t>(InputBitrate() / 8, 1);
+        auto due = [this, bytesPerSecond](int64_t bytes)
+        {
+          return m_openTime + std::chrono::microseconds(bytes * 1000000 / bytesPerSecond);
+        };
+
+        std::this_thread::sleep_until(due(m_delivered + DATAGRAM_LENGTH));
+
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_openTime).count();
+        int64_t available = std::max<int64_t>(elapsed * bytesPerSecond / 1000000 - m_delivered, DATAGRAM_LENGTH);
+        size_t length = static_cast<size_t>(std::min<int64_t>(available, static_cast<int64_t>(size)));
+
+        ssize_t bytesRead = ::read(m_fd, ptr, length);
+
+        // Loop around at the end of the file
+        if (bytesRead == 0 && ::lseek(m_fd, 0, SEEK_SET) == 0)
+          bytesRead = ::read(m_fd, ptr, length);
+
+        if (bytesRead > 0)
+          m_delivered += bytesRead;
+
+        return bytesRead;
+      }
+
+      ssize_t Write(const void* ptr, size_t size) { return ::write(m_fd, ptr, size); }
+
+      int64_t Seek(int64_t position, int whence = SEEK_SET) { return ::lseek(m_fd, position, whence); }
+
+    private:
+      // Seven TS packets, i.e. what the gateway sends in a single datagram
+      static constexpr int64_t DATAGRAM_LENGTH = 188 * 7;
+
+      int m_fd = -1;
+      bool m_live = false;
+      std::chrono::steady_clock::time_point m_openTime;
+      int64_t m_delivered = 0;
+    };
+  } // namespace vfs
+} // namespace kodi
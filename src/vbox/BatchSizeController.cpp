@@ -0,0 +1,85 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "BatchSizeController.h"
+
+#include <algorithm>
+
+#include <kodi/General.h>
+
+using namespace vbox;
+
+const double BatchSizeController::SAMPLE_WEIGHT = 0.3;
+
+BatchSizeController::BatchSizeController(const std::string& name,
+                                         int initialSize,
+                                         int minSize,
+                                         int maxSize,
+                                         size_t targetBytes,
+                                         std::chrono::milliseconds targetLatency)
+  : m_name(name),
+    m_minSize(minSize),
+    m_maxSize(maxSize),
+    m_targetBytes(targetBytes),
+    m_targetLatency(targetLatency),
+    m_batchSize(initialSize)
+{
+}
+
+int BatchSizeController::GetBatchSize() const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_batchSize;
+}
+
+void BatchSizeController::AddSample(int numChannels, size_t bytes, std::chrono::milliseconds latency)
+{
+  if (numChannels <= 0)
+    return;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  double bytesPerChannel = static_cast<double>(bytes) / numChannels;
+  double msPerChannel = static_cast<double>(latency.count()) / numChannels;
+
+  if (m_numSamples++ == 0)
+  {
+    m_bytesPerChannel = bytesPerChannel;
+    m_msPerChannel = msPerChannel;
+  }
+  else
+  {
+    m_bytesPerChannel += SAMPLE_WEIGHT * (bytesPerChannel - m_bytesPerChannel);
+    m_msPerChannel += SAMPLE_WEIGHT * (msPerChannel - m_msPerChannel);
+  }
+
+  // Pick the largest window that stays within both targets
+  double sizeForBytes = m_bytesPerChannel > 0 ? m_targetBytes / m_bytesPerChannel : m_maxSize;
+  double sizeForLatency = m_msPerChannel > 0 ? m_targetLatency.count() / m_msPerChannel : m_maxSize;
+  int desiredSize = static_cast<int>(std::min(sizeForBytes, sizeForLatency));
+
+  // Don't change more than a factor of two at a time, single slow responses
+  // shouldn't make the batch size swing wildly
+  desiredSize = std::min(std::max(desiredSize, m_batchSize / 2), m_batchSize * 2);
+  desiredSize = std::min(std::max(desiredSize, m_minSize), m_maxSize);
+
+  if (desiredSize != m_batchSize)
+  {
+    kodi::Log(ADDON_LOG_DEBUG, "%s batch size changed from %d to %d channels (%.0f bytes and %.0f ms per channel)",
+              m_name.c_str(), m_batchSize, desiredSize, m_bytesPerChannel, m_msPerChannel);
+    m_batchSize = desiredSize;
+  }
+}
+
+void BatchSizeController::LogStatistics(const std::string& backendName) const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  kodi::Log(ADDON_LOG_INFO, "%s batch size for %s: %d channels (%.0f bytes and %.0f ms per channel over %u requests)",
+            m_name.c_str(), backendName.c_str(), m_batchSize, m_bytesPerChannel, m_msPerChannel, m_numSamples);
+}
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace vbox
+{
+
+  /**
+   * Decides how many channels to request per batch for the API methods that
+   * take a FromChIndex/ToChIndex window. The controller measures the size and
+   * latency of each response and grows or shrinks the window so that a batch
+   * stays close to the target response size and latency.
+   */
+  class BatchSizeController
+  {
+  public:
+    /**
+     * @param name the name of the batches (used for logging)
+     * @param initialSize the batch size to use until samples are available
+     * @param minSize the smallest allowed batch size
+     * @param maxSize the largest allowed batch size
+     * @param targetBytes the desired response size
+     * @param targetLatency the desired response time
+     */
+    BatchSizeController(const std::string& name,
+                        int initialSize,
+                        int minSize,
+                        int maxSize,
+                        size_t targetBytes,
+                        std::chrono::milliseconds targetLatency);
+    ~BatchSizeController() = default;
+
+    /**
+     * @return the number of channels the next batch should contain
+     */
+    int GetBatchSize() const;
+
+    /**
+     * Records the outcome of a batch request and adjusts the batch size
+     * @param numChannels the number of channels the batch contained
+     * @param bytes the size of the response
+     * @param latency the time it took to perform the request
+     */
+    void AddSample(int numChannels, size_t bytes, std::chrono::milliseconds latency);
+
+    /**
+     * Logs the current batch size and the measurements it is based on
+     * @param backendName the name of the backend model
+     */
+    void LogStatistics(const std::string& backendName) const;
+
+  private:
+    /**
+     * The weight of a new sample in the moving averages
+     */
+    static const double SAMPLE_WEIGHT;
+
+    std::string m_name;
+    int m_minSize;
+    int m_maxSize;
+    size_t m_targetBytes;
+    std::chrono::milliseconds m_targetLatency;
+
+    /**
+     * The current batch size
+     */
+    int m_batchSize;
+
+    /**
+     * Moving averages of the response size and latency per channel
+     */
+    double m_bytesPerChannel = 0;
+    double m_msPerChannel = 0;
+
+    /**
+     * The number of samples recorded
+     */
+    unsigned int m_numSamples = 0;
+
+    mutable std::mutex m_mutex;
+  };
+} // namespace vbox
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "CacheFile.h"
+
+#include "Utilities.h"
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+#include <kodi/Filesystem.h>
+#include <kodi/General.h>
+
+using namespace vbox;
+
+namespace
+{
+  const std::string CACHE_DIRECTORY = "special://userdata/addon_data/pvr.vbox/";
+  const std::string CACHE_MAGIC = "VBXC";
+} // unnamed namespace
+
+void CacheWriter::WriteUInt32(uint32_t value)
+{
+  m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void CacheWriter::WriteInt64(int64_t value)
+{
+  m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void CacheWriter::WriteString(const std::string& value)
+{
+  WriteUInt32(static_cast<uint32_t>(value.size()));
+  m_buffer.append(value);
+}
+
+void CacheWriter::WriteStrings(const std::vector<std::string>& values)
+{
+  WriteUInt32(static_cast<uint32_t>(values.size()));
+  for (const auto& value : values)
+    WriteString(value);
+}
+
+uint32_t CacheReader::ReadUInt32()
+{
+  uint32_t value = 0;
+  Read(&value, sizeof(value));
+  return value;
+}
+
+int64_t CacheReader::ReadInt64()
+{
+  int64_t value = 0;
+  Read(&value, sizeof(value));
+  return value;
+}
+
+std::string CacheReader::ReadString()
+{
+  uint32_t length = ReadUInt32();
+
+  if (!Has(length))
+    return "";
+
+  std::string value = m_contents->substr(m_position, length);
+  m_position += length;
+  return value;
+}
+
+std::vector<std::string> CacheReader::ReadStrings()
+{
+  std::vector<std::string> values;
+  uint32_t count = ReadUInt32();
+
+  for (uint32_t i = 0; i < count && m_valid; i++)
+    values.push_back(ReadString());
+
+  return values;
+}
+
+bool CacheReader::Has(size_t length)
+{
+  if (m_valid && m_contents->size() - m_position < length)
+    m_valid = false;
+
+  return m_valid;
+}
+
+void CacheReader::Read(void* value, size_t length)
+{
+  if (!Has(length))
+    return;
+
+  std::memcpy(value, m_contents->data() + m_position, length);
+  m_position += length;
+}
+
+CacheFile::CacheFile(const std::string& name, unsigned int formatVersion, const std::string& gatewayId)
+  : m_formatVersion(formatVersion), m_gatewayId(gatewayId)
+{
+  // Use a separate file per gateway
+  std::stringstream ss;
+  ss << CACHE_DIRECTORY << name << "_cache_" << std::hex << std::hash<std::string>()(gatewayId) << ".bin";
+  m_path = ss.str();
+}
+
+std::unique_ptr<CacheReader> CacheFile::Open(unsigned int& dbVersion) const
+{
+  kodi::vfs::CFile fileHandle;
+
+  if (!kodi::vfs::FileExists(m_path) || !fileHandle.OpenFile(m_path, ADDON_READ_NO_CACHE))
+    return nullptr;
+
+  std::unique_ptr<CacheReader> reader(new CacheReader(utilities::ReadFileContents(fileHandle)));
+  fileHandle.Close();
+
+  // Check that the cache is usable at all
+  if (reader->ReadString() != CACHE_MAGIC || reader->ReadUInt32() != m_formatVersion ||
+      reader->ReadString() != m_gatewayId)
+    return nullptr;
+
+  dbVersion = reader->ReadUInt32();
+
+  if (!reader->IsValid())
+    return nullptr;
+
+  return reader;
+}
+
+CacheWriter CacheFile::CreateWriter(unsigned int dbVersion) const
+{
+  CacheWriter writer;
+
+  writer.WriteString(CACHE_MAGIC);
+  writer.WriteUInt32(m_formatVersion);
+  writer.WriteString(m_gatewayId);
+  writer.WriteUInt32(dbVersion);
+
+  return writer;
+}
+
+bool CacheFile::Save(const CacheWriter& writer) const
+{
+  // Write to a temporary file first so that a crash never leaves a partial
+  // cache behind
+  const std::string temporaryPath = m_path + ".tmp";
+  const std::string& buffer = writer.GetBuffer();
+  kodi::vfs::CFile fileHandle;
+
+  if (!fileHandle.OpenFileForWrite(temporaryPath, true))
+  {
+    kodi::Log(ADDON_LOG_ERROR, "Failed to open %s for writing", temporaryPath.c_str());
+    return false;
+  }
+
+  bool written = fileHandle.Write(buffer.data(), buffer.size()) == static_cast<ssize_t>(buffer.size());
+  fileHandle.Close();
+
+  // Not all platforms can rename over an existing file
+  if (written && kodi::vfs::FileExists(m_path))
+    kodi::vfs::DeleteFile(m_path);
+
+  if (!written || !kodi::vfs::RenameFile(temporaryPath, m_path))
+  {
+    kodi::Log(ADDON_LOG_ERROR, "Failed to write the cache file %s", m_path.c_str());
+    kodi::vfs::DeleteFile(temporaryPath);
+    return false;
+  }
+
+  kodi::Log(ADDON_LOG_DEBUG, "Wrote %d bytes to the cache file %s", static_cast<int>(buffer.size()), m_path.c_str());
+  return true;
+}
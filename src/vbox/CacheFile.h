@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vbox
+{
+
+  /**
+   * Serializes values into a buffer for writing to a cache file
+   */
+  class CacheWriter
+  {
+  public:
+    void WriteUInt32(uint32_t value);
+    void WriteInt64(int64_t value);
+    void WriteString(const std::string& value);
+    void WriteStrings(const std::vector<std::string>& values);
+
+    const std::string& GetBuffer() const { return m_buffer; }
+
+  private:
+    std::string m_buffer;
+  };
+
+  /**
+   * Deserializes values from the contents of a cache file. Reading past the
+   * end marks the reader as invalid and yields empty values from then on
+   */
+  class CacheReader
+  {
+  public:
+    explicit CacheReader(std::unique_ptr<std::string> contents) : m_contents(std::move(contents)) {}
+
+    uint32_t ReadUInt32();
+    int64_t ReadInt64();
+    std::string ReadString();
+    std::vector<std::string> ReadStrings();
+
+    /**
+     * @return false if the reader has run past the end of the contents
+     */
+    bool IsValid() const { return m_valid; }
+
+    /**
+     * @return whether all contents have been read
+     */
+    bool AtEnd() const { return m_position == m_contents->size(); }
+
+  private:
+    bool Has(size_t length);
+    void Read(void* value, size_t length);
+
+    std::unique_ptr<std::string> m_contents;
+    size_t m_position = 0;
+    bool m_valid = true;
+  };
+
+  /**
+   * A binary cache file in the addon's data directory. Every file belongs to
+   * one gateway and records the backend database version its contents
+   * correspond to.
+   */
+  class CacheFile
+  {
+  public:
+    /**
+     * @param name the name of the cache (used in the file name)
+     * @param formatVersion the version of the file format, files written
+     * with another version are ignored
+     * @param gatewayId identifies the gateway the cache belongs to
+     */
+    CacheFile(const std::string& name, unsigned int formatVersion, const std::string& gatewayId);
+    ~CacheFile() = default;
+
+    /**
+     * Opens the cache for reading
+     * @param dbVersion set to the database version the contents correspond to
+     * @return a reader positioned after the header, or nullptr if there is no
+     * usable cache
+     */
+    std::unique_ptr<CacheReader> Open(unsigned int& dbVersion) const;
+
+    /**
+     * @param dbVersion the database version the contents correspond to
+     * @return a writer that has the header written to it
+     */
+    CacheWriter CreateWriter(unsigned int dbVersion) const;
+
+    /**
+     * Replaces the cache file with the contents of the writer
+     * @return whether the file was written
+     */
+    bool Save(const CacheWriter& writer) const;
+
+    /**
+     * @return the path to the cache file
+     */
+    const std::string& GetPath() const { return m_path; }
+
+  private:
+    unsigned int m_formatVersion;
+    std::string m_gatewayId;
+    std::string m_path;
+  };
+} // namespace vbox
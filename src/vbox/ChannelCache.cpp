@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "ChannelCache.h"
+
+#include <kodi/General.h>
+
+using namespace vbox;
+
+const unsigned int ChannelCache::FORMAT_VERSION = 1;
+
+ChannelCache::ChannelCache(const std::string& gatewayId) : m_file("channels", FORMAT_VERSION, gatewayId)
+{
+}
+
+bool ChannelCache::Load(std::vector<ChannelPtr>& channels, unsigned int& dbVersion) const
+{
+  std::unique_ptr<CacheReader> reader = m_file.Open(dbVersion);
+
+  if (!reader)
+    return false;
+
+  std::vector<ChannelPtr> cachedChannels;
+  uint32_t numChannels = reader->ReadUInt32();
+
+  for (uint32_t i = 0; i < numChannels && reader->IsValid(); i++)
+  {
+    std::string uniqueId = reader->ReadString();
+    std::string xmltvName = reader->ReadString();
+    std::string name = reader->ReadString();
+    std::string url = reader->ReadString();
+    ChannelPtr channel(new Channel(uniqueId, xmltvName, name, url));
+
+    channel->m_index = reader->ReadUInt32();
+    channel->m_number = reader->ReadUInt32();
+    channel->m_iconUrl = reader->ReadString();
+    channel->m_radio = reader->ReadUInt32() != 0;
+    channel->m_encrypted = reader->ReadUInt32() != 0;
+
+    cachedChannels.push_back(channel);
+  }
+
+  if (!reader->IsValid() || !reader->AtEnd())
+  {
+    kodi::Log(ADDON_LOG_ERROR, "Channel cache %s is corrupt, ignoring it", m_file.GetPath().c_str());
+    return false;
+  }
+
+  channels = std::move(cachedChannels);
+  return true;
+}
+
+void ChannelCache::Save(const std::vector<ChannelPtr>& channels, unsigned int dbVersion) const
+{
+  CacheWriter writer = m_file.CreateWriter(dbVersion);
+
+  writer.WriteUInt32(static_cast<uint32_t>(channels.size()));
+
+  for (const auto& channel : channels)
+  {
+    writer.WriteString(channel->m_uniqueId);
+    writer.WriteString(channel->m_xmltvName);
+    writer.WriteString(channel->m_name);
+    writer.WriteString(channel->m_url);
+    writer.WriteUInt32(channel->m_index);
+    writer.WriteUInt32(channel->m_number);
+    writer.WriteString(channel->m_iconUrl);
+    writer.WriteUInt32(channel->m_radio ? 1 : 0);
+    writer.WriteUInt32(channel->m_encrypted ? 1 : 0);
+  }
+
+  m_file.Save(writer);
+}
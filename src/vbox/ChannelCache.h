@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "CacheFile.h"
+#include "Channel.h"
+
+#include <string>
+#include <vector>
+
+namespace vbox
+{
+
+  /**
+   * Stores the channel list on disk so that it can be used immediately on the
+   * next startup. A cache is only valid for the channels database version it
+   * was written for.
+   */
+  class ChannelCache
+  {
+  public:
+    /**
+     * @param gatewayId identifies the gateway the channels belong to
+     */
+    explicit ChannelCache(const std::string& gatewayId);
+    ~ChannelCache() = default;
+
+    /**
+     * Loads the cached channels
+     * @param channels receives the channels
+     * @param dbVersion set to the channels database version of the cached list
+     * @return false if there is no usable cache
+     */
+    bool Load(std::vector<ChannelPtr>& channels, unsigned int& dbVersion) const;
+
+    /**
+     * Replaces the cache with the specified channels
+     * @param channels the channels
+     * @param dbVersion the channels database version of the list
+     */
+    void Save(const std::vector<ChannelPtr>& channels, unsigned int dbVersion) const;
+
+  private:
+    /**
+     * Identifies the file format, bump when the format changes
+     */
+    static const unsigned int FORMAT_VERSION;
+
+    CacheFile m_file;
+  };
+} // namespace vbox
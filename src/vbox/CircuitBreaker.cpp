@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "CircuitBreaker.h"
+
+#include <algorithm>
+
+using namespace vbox;
+
+CircuitBreaker::CircuitBreaker(unsigned int failureThreshold, std::chrono::milliseconds openDuration,
+                               std::chrono::milliseconds maxOpenDuration)
+  : m_failureThreshold(failureThreshold),
+    m_initialOpenDuration(openDuration),
+    m_maxOpenDuration(maxOpenDuration),
+    m_openDuration(openDuration)
+{
+}
+
+bool CircuitBreaker::AllowRequest()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  switch (m_state)
+  {
+    case CircuitState::CLOSED:
+      return true;
+    case CircuitState::OPEN:
+      if (std::chrono::steady_clock::now() - m_openedAt < m_openDuration)
+        return false;
+
+      // Let a single request through to see if the gateway has recovered
+      m_state = CircuitState::HALF_OPEN;
+      m_trialInProgress = true;
+      return true;
+    case CircuitState::HALF_OPEN:
+      if (m_trialInProgress)
+        return false;
+
+      m_trialInProgress = true;
+      return true;
+  }
+
+  return true;
+}
+
+void CircuitBreaker::RecordSuccess()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_failures = 0;
+  m_trialInProgress = false;
+  m_openDuration = m_initialOpenDuration;
+
+  if (m_state != CircuitState::CLOSED)
+    SetState(CircuitState::CLOSED, lock);
+}
+
+void CircuitBreaker::RecordFailure()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_failures++;
+
+  if (m_state == CircuitState::HALF_OPEN)
+  {
+    // The trial failed, stay open for longer this time
+    m_trialInProgress = false;
+    m_openDuration = std::min(m_openDuration * 2, m_maxOpenDuration);
+    m_openedAt = std::chrono::steady_clock::now();
+    m_state = CircuitState::OPEN;
+  }
+  else if (m_state == CircuitState::CLOSED && m_failures >= m_failureThreshold)
+  {
+    m_openedAt = std::chrono::steady_clock::now();
+    SetState(CircuitState::OPEN, lock);
+  }
+}
+
+CircuitState CircuitBreaker::GetState() const
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_state;
+}
+
+void CircuitBreaker::SetState(CircuitState state, std::unique_lock<std::mutex>& lock)
+{
+  m_state = state;
+  lock.unlock();
+
+  if (OnStateChanged)
+    OnStateChanged(state);
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+namespace vbox
+{
+
+  /**
+   * The states of a circuit breaker
+   */
+  enum class CircuitState
+  {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+  };
+
+  /**
+   * Stops requests from being made to a gateway that doesn't respond. The
+   * circuit opens after a number of consecutive failures, after which requests
+   * are refused until a cool-down period has passed. A single trial request is
+   * then let through, and depending on its outcome the circuit either closes
+   * again or stays open for another (longer) period.
+   */
+  class CircuitBreaker
+  {
+  public:
+    /**
+     * @param failureThreshold the number of consecutive failures that opens
+     * the circuit
+     * @param openDuration how long the circuit stays open the first time
+     * @param maxOpenDuration the longest the circuit stays open
+     */
+    CircuitBreaker(unsigned int failureThreshold, std::chrono::milliseconds openDuration,
+                   std::chrono::milliseconds maxOpenDuration);
+    ~CircuitBreaker() = default;
+
+    /**
+     * @return whether a request may be made. Every request that is allowed
+     * must be followed by a call to RecordSuccess() or RecordFailure()
+     */
+    bool AllowRequest();
+
+    /**
+     * Records that the gateway responded
+     */
+    void RecordSuccess();
+
+    /**
+     * Records that the gateway could not be reached
+     */
+    void RecordFailure();
+
+    /**
+     * @return the current state
+     */
+    CircuitState GetState() const;
+
+    /**
+     * Called (outside the lock) whenever the circuit opens or closes
+     */
+    std::function<void(CircuitState state)> OnStateChanged;
+
+  private:
+    void SetState(CircuitState state, std::unique_lock<std::mutex>& lock);
+
+    const unsigned int m_failureThreshold;
+    const std::chrono::milliseconds m_initialOpenDuration;
+    const std::chrono::milliseconds m_maxOpenDuration;
+
+    CircuitState m_state = CircuitState::CLOSED;
+    unsigned int m_failures = 0;
+    bool m_trialInProgress = false;
+    std::chrono::milliseconds m_openDuration;
+    std::chrono::steady_clock::time_point m_openedAt;
+    mutable std::mutex m_mutex;
+  };
+} // namespace vbox
@@ -41,7 +41,7 @@ namespace vbox
     static unsigned int GetUniqueId(const vbox::Recording* recording)
     {
       std::hash<std::string> hasher;
-      std::string timestamp = std::to_string(::xmltv::Utilities::XmltvToUnixTime(recording->m_endTime));
+      std::string timestamp = std::to_string(recording->m_endTimestamp);
       int uniqueId = hasher(std::string(recording->m_title) + timestamp);
       return std::abs(uniqueId);
     }
@@ -53,7 +53,7 @@ namespace vbox
     static unsigned int GetUniqueId(const vbox::SeriesRecording* series)
     {
       std::hash<std::string> hasher;
-      std::string timestamp = std::to_string(::xmltv::Utilities::XmltvToUnixTime(series->m_endTime));
+      std::string timestamp = std::to_string(series->m_endTimestamp);
       int uniqueId = hasher(std::string(series->m_title) + timestamp);
       return std::abs(uniqueId);
     }
@@ -64,7 +64,7 @@ namespace vbox
     static unsigned int GetUniqueId(const xmltv::Programme* programme)
     {
       std::hash<std::string> hasher;
-      std::string timestamp = std::to_string(::xmltv::Utilities::XmltvToUnixTime(programme->m_endTime));
+      std::string timestamp = std::to_string(programme->m_endTimestamp);
       int uniqueId = hasher(std::string(programme->m_title) + timestamp);
       return std::abs(uniqueId);
     }
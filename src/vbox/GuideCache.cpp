@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "GuideCache.h"
+
+#include <kodi/General.h>
+
+using namespace vbox;
+using namespace xmltv;
+
+const unsigned int GuideCache::FORMAT_VERSION = 1;
+
+GuideCache::GuideCache(const std::string& gatewayId) : m_file("guide", FORMAT_VERSION, gatewayId)
+{
+}
+
+std::unique_ptr<Guide> GuideCache::Load(unsigned int& dbVersion) const
+{
+  std::unique_ptr<CacheReader> cacheReader = m_file.Open(dbVersion);
+
+  if (!cacheReader)
+    return nullptr;
+
+  CacheReader& reader = *cacheReader;
+  std::unique_ptr<Guide> guide(new Guide());
+
+  uint32_t numMappings = reader.ReadUInt32();
+  for (uint32_t i = 0; i < numMappings && reader.IsValid(); i++)
+  {
+    std::string displayName = reader.ReadString();
+    guide->AddDisplayNameMapping(displayName, reader.ReadString());
+  }
+
+  uint32_t numSchedules = reader.ReadUInt32();
+  for (uint32_t i = 0; i < numSchedules && reader.IsValid(); i++)
+  {
+    std::string channelId = reader.ReadString();
+    std::string displayName = reader.ReadString();
+    ChannelPtr channel(new xmltv::Channel(channelId, displayName));
+    channel->m_icon = reader.ReadString();
+
+    SchedulePtr schedule(new xmltv::Schedule(channel));
+
+    uint32_t numProgrammes = reader.ReadUInt32();
+    for (uint32_t j = 0; j < numProgrammes && reader.IsValid(); j++)
+    {
+      ProgrammePtr programme(new Programme());
+
+      programme->m_startTime = reader.ReadString();
+      programme->m_endTime = reader.ReadString();
+      programme->m_startTimestamp = static_cast<time_t>(reader.ReadInt64());
+      programme->m_endTimestamp = static_cast<time_t>(reader.ReadInt64());
+      programme->m_channelName = reader.ReadString();
+      programme->m_title = reader.ReadString();
+      programme->m_description = reader.ReadString();
+      programme->m_icon = reader.ReadString();
+      programme->m_subTitle = reader.ReadString();
+
+      uint32_t numSeriesIds = reader.ReadUInt32();
+      for (uint32_t k = 0; k < numSeriesIds && reader.IsValid(); k++)
+      {
+        std::string system = reader.ReadString();
+        programme->m_seriesIds[system] = reader.ReadString();
+      }
+
+      programme->m_year = static_cast<int>(reader.ReadInt64());
+      programme->m_starRating = reader.ReadString();
+
+      programme->m_credits.directors = reader.ReadStrings();
+      programme->m_credits.producers = reader.ReadStrings();
+      programme->m_credits.writers = reader.ReadStrings();
+
+      uint32_t numActors = reader.ReadUInt32();
+      for (uint32_t k = 0; k < numActors && reader.IsValid(); k++)
+      {
+        Actor actor;
+        actor.role = reader.ReadString();
+        actor.name = reader.ReadString();
+        programme->m_credits.actors.push_back(actor);
+      }
+
+      programme->m_categories = reader.ReadStrings();
+
+      schedule->AddProgramme(programme);
+    }
+
+    guide->AddSchedule(channelId, schedule);
+  }
+
+  if (!reader.IsValid() || !reader.AtEnd())
+  {
+    kodi::Log(ADDON_LOG_ERROR, "Guide cache %s is corrupt, ignoring it", m_file.GetPath().c_str());
+    return nullptr;
+  }
+
+  return guide;
+}
+
+void GuideCache::Save(const Guide& guide, unsigned int dbVersion) const
+{
+  CacheWriter writer = m_file.CreateWriter(dbVersion);
+
+  const auto& mappings = guide.GetDisplayNameMappings();
+  writer.WriteUInt32(static_cast<uint32_t>(mappings.size()));
+  for (const auto& mapping : mappings)
+  {
+    writer.WriteString(mapping.first);
+    writer.WriteString(mapping.second);
+  }
+
+  const auto& schedules = guide.GetSchedules();
+  writer.WriteUInt32(static_cast<uint32_t>(schedules.size()));
+  for (const auto& entry : schedules)
+  {
+    const auto& channel = entry.second->GetChannel();
+    const auto& programmes = entry.second->GetProgrammes();
+
+    writer.WriteString(entry.first);
+    writer.WriteString(channel->m_displayName);
+    writer.WriteString(channel->m_icon);
+
+    writer.WriteUInt32(static_cast<uint32_t>(programmes.size()));
+    for (const auto& programme : programmes)
+    {
+      writer.WriteString(programme->m_startTime);
+      writer.WriteString(programme->m_endTime);
+      writer.WriteInt64(static_cast<int64_t>(programme->m_startTimestamp));
+      writer.WriteInt64(static_cast<int64_t>(programme->m_endTimestamp));
+      writer.WriteString(programme->m_channelName);
+      writer.WriteString(programme->m_title);
+      writer.WriteString(programme->m_description);
+      writer.WriteString(programme->m_icon);
+      writer.WriteString(programme->m_subTitle);
+
+      writer.WriteUInt32(static_cast<uint32_t>(programme->m_seriesIds.size()));
+      for (const auto& seriesId : programme->m_seriesIds)
+      {
+        writer.WriteString(seriesId.first);
+        writer.WriteString(seriesId.second);
+      }
+
+      writer.WriteInt64(programme->m_year);
+      writer.WriteString(programme->m_starRating);
+
+      writer.WriteStrings(programme->GetDirectors());
+      writer.WriteStrings(programme->GetProducers());
+      writer.WriteStrings(programme->GetWriters());
+
+      const auto& actors = programme->GetActors();
+      writer.WriteUInt32(static_cast<uint32_t>(actors.size()));
+      for (const auto& actor : actors)
+      {
+        writer.WriteString(actor.role);
+        writer.WriteString(actor.name);
+      }
+
+      writer.WriteStrings(programme->GetCategories());
+    }
+  }
+
+  m_file.Save(writer);
+}
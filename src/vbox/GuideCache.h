@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "../xmltv/Guide.h"
+#include "CacheFile.h"
+
+#include <memory>
+#include <string>
+
+namespace vbox
+{
+
+  /**
+   * Stores a parsed guide on disk in a compact binary format so that it can
+   * be used immediately on the next startup. Each gateway has its own cache
+   * file, and a cache is only valid for the programs database version it was
+   * written for.
+   */
+  class GuideCache
+  {
+  public:
+    /**
+     * @param gatewayId identifies the gateway the guide belongs to
+     */
+    explicit GuideCache(const std::string& gatewayId);
+    ~GuideCache() = default;
+
+    /**
+     * Loads the cached guide
+     * @param dbVersion set to the programs database version of the cached guide
+     * @return the guide, or nullptr if there is no usable cache
+     */
+    std::unique_ptr<::xmltv::Guide> Load(unsigned int& dbVersion) const;
+
+    /**
+     * Replaces the cache with the specified guide
+     * @param guide the guide
+     * @param dbVersion the programs database version of the guide
+     */
+    void Save(const ::xmltv::Guide& guide, unsigned int dbVersion) const;
+
+  private:
+    /**
+     * Identifies the file format, bump when the format changes
+     */
+    static const unsigned int FORMAT_VERSION;
+
+    CacheFile m_file;
+  };
+} // namespace vbox
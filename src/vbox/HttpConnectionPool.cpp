@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "HttpConnectionPool.h"
+
+#include <algorithm>
+
+#include <kodi/General.h>
+
+using namespace vbox;
+
+namespace
+{
+  // How long Kodi is assumed to keep an idle HTTP session around for reuse
+  const std::chrono::seconds KEEP_ALIVE_TIMEOUT(3);
+} // unnamed namespace
+
+HttpConnection::HttpConnection(HttpConnectionPool& pool, size_t slot) : m_pool(pool), m_slot(slot)
+{
+}
+
+HttpConnection::~HttpConnection()
+{
+  if (m_opened)
+    m_file.Close();
+
+  // Only a connection that was opened successfully can be reused
+  m_pool.Release(m_slot, m_opened);
+}
+
+bool HttpConnection::Open(const std::string& url)
+{
+  if (!m_file.CURLCreate(url))
+    return false;
+
+  m_file.CURLAddOption(ADDON_CURL_OPTION_HEADER, "Connection", "keep-alive");
+  m_opened = m_file.CURLOpen(ADDON_READ_NO_CACHE);
+
+  return m_opened;
+}
+
+HttpConnectionPool::HttpConnectionPool(size_t size)
+  : m_slots(std::max<size_t>(size, 1)), m_requests(0), m_likelyNew(0), m_likelyReused(0)
+{
+}
+
+HttpConnectionPtr HttpConnectionPool::Acquire(const std::string& authority)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_condition.wait(lock, [this]()
+  {
+    for (const auto& slot : m_slots)
+    {
+      if (!slot.busy)
+        return true;
+    }
+
+    return false;
+  });
+
+  auto now = std::chrono::steady_clock::now();
+  size_t chosen = m_slots.size();
+  bool reused = false;
+
+  // Prefer the most recently released slot that should still be connected to
+  // the same host, otherwise take the one that has been idle the longest
+  for (size_t i = 0; i < m_slots.size(); i++)
+  {
+    const Slot& slot = m_slots[i];
+
+    if (slot.busy)
+      continue;
+
+    bool alive = slot.alive && slot.authority == authority && now - slot.releasedAt < KEEP_ALIVE_TIMEOUT;
+
+    if (alive && (!reused || slot.releasedAt > m_slots[chosen].releasedAt))
+    {
+      chosen = i;
+      reused = true;
+    }
+    else if (!reused && (chosen == m_slots.size() || slot.releasedAt < m_slots[chosen].releasedAt))
+      chosen = i;
+  }
+
+  Slot& slot = m_slots[chosen];
+  slot.busy = true;
+  slot.authority = authority;
+
+  m_requests++;
+
+  if (reused)
+    m_likelyReused++;
+  else
+    m_likelyNew++;
+
+  return HttpConnectionPtr(new HttpConnection(*this, chosen));
+}
+
+void HttpConnectionPool::Release(size_t slot, bool keepAlive)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots[slot].busy = false;
+    m_slots[slot].alive = keepAlive;
+    m_slots[slot].releasedAt = std::chrono::steady_clock::now();
+  }
+
+  m_condition.notify_one();
+}
+
+void HttpConnectionPool::LogStatistics() const
+{
+  kodi::Log(ADDON_LOG_DEBUG, "HTTP connections: %u requests, %u likely new, %u likely reused (estimated)",
+            m_requests.load(), m_likelyNew.load(), m_likelyReused.load());
+}
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <kodi/Filesystem.h>
+
+namespace vbox
+{
+
+  class HttpConnectionPool;
+
+  /**
+   * A connection leased from the pool. The connection is returned to the pool
+   * when the object is destroyed
+   */
+  class HttpConnection
+  {
+  public:
+    HttpConnection(HttpConnectionPool& pool, size_t slot);
+    ~HttpConnection();
+
+    HttpConnection(const HttpConnection&) = delete;
+    HttpConnection& operator=(const HttpConnection&) = delete;
+
+    /**
+     * Opens the specified URL, asking the server to keep the connection alive
+     * @param url the URL
+     * @return whether the URL could be opened
+     */
+    bool Open(const std::string& url);
+
+    /**
+     * @return the file handle, valid after a successful call to Open()
+     */
+    kodi::vfs::CFile& GetFile() { return m_file; }
+
+  private:
+    HttpConnectionPool& m_pool;
+    size_t m_slot;
+    kodi::vfs::CFile m_file;
+    bool m_opened = false;
+  };
+
+  typedef std::unique_ptr<HttpConnection> HttpConnectionPtr;
+
+  /**
+   * Bounds the number of simultaneous HTTP requests to the gateway. The pool
+   * only limits concurrency, it doesn't hold any connections itself: every
+   * request opens its own CFile, which is closed again once the request is
+   * done. Whether the underlying connection is reused is up to Kodi, which
+   * keeps idle HTTP sessions around for a short while and reuses them for the
+   * next request to the same host. Keeping the number of concurrent requests
+   * small makes that reuse more likely.
+   *
+   * The add-on can't observe Kodi's session cache, so the reuse counters are
+   * estimates based on how recently a slot was released
+   */
+  class HttpConnectionPool
+  {
+  public:
+    /**
+     * @param size the maximum number of simultaneous connections
+     */
+    explicit HttpConnectionPool(size_t size);
+    ~HttpConnectionPool() = default;
+
+    /**
+     * Leases a connection, waiting for one to become available if they are
+     * all in use
+     * @param authority the host and port the connection will be made to
+     * @return the connection
+     */
+    HttpConnectionPtr Acquire(const std::string& authority);
+
+    /**
+     * Logs how many requests have been made and how many of them likely
+     * reused a connection (estimated)
+     */
+    void LogStatistics() const;
+
+  private:
+    friend class HttpConnection;
+
+    /**
+     * A request slot. A slot that was released recently is assumed to still
+     * have a live connection to its authority in Kodi's session cache
+     */
+    struct Slot
+    {
+      std::string authority;
+      std::chrono::steady_clock::time_point releasedAt;
+      bool busy = false;
+      bool alive = false;
+    };
+
+    void Release(size_t slot, bool keepAlive);
+
+    std::vector<Slot> m_slots;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    std::atomic<unsigned int> m_requests;
+
+    /**
+     * Requests that likely needed a new connection or likely reused one,
+     * estimated from KEEP_ALIVE_TIMEOUT rather than measured
+     */
+    std::atomic<unsigned int> m_likelyNew;
+    std::atomic<unsigned int> m_likelyReused;
+  };
+} // namespace vbox
@@ -30,8 +30,13 @@ void InstanceSettings::ReadSettings()
   m_externalConnectionParams.timeout = kodi::addon::GetSettingInt("connection_timeout", 10);
 
   m_setChannelIdUsingOrder = kodi::addon::GetSettingEnum<vbox::ChannelOrder>("set_channelid_using_order", CH_ORDER_BY_LCN);
+  m_guideFetchConcurrency = kodi::addon::GetSettingInt("guide_fetch_concurrency", 4);
   m_timeshiftEnabled = kodi::addon::GetSettingBoolean("timeshift_enabled", false);
+  m_timeshiftBufferType = kodi::addon::GetSettingEnum<vbox::TimeshiftBufferType>("timeshift_buffer_type", TIMESHIFT_BUFFER_FILESYSTEM);
   m_timeshiftBufferPath = kodi::addon::GetSettingString("timeshift_path", "");
+  m_timeshiftBufferSize = kodi::addon::GetSettingInt("timeshift_buffer_size", 0);
+  m_timeshiftMemorySize = kodi::addon::GetSettingInt("timeshift_memory_size", 64);
+  m_timeshiftLowLatency = kodi::addon::GetSettingBoolean("timeshift_low_latency", false);
 }
 
 ADDON_STATUS InstanceSettings::SetSetting(const std::string& settingName, const kodi::addon::CSettingValue& settingValue)
@@ -80,8 +85,13 @@ ADDON_STATUS InstanceSettings::SetSetting(const std::string& settingName, const
   UPDATE_INT("external_upnp_port", m_externalConnectionParams.upnpPort);
   UPDATE_INT("external_connection_timeout", m_externalConnectionParams.timeout);
   UPDATE_INT("set_channelid_using_order", m_setChannelIdUsingOrder);
+  UPDATE_INT("guide_fetch_concurrency", m_guideFetchConcurrency);
   UPDATE_BOOL("timeshift_enabled", m_timeshiftEnabled);
+  UPDATE_INT("timeshift_buffer_type", m_timeshiftBufferType);
   UPDATE_STR("timeshift_path", m_timeshiftBufferPath);
+  UPDATE_INT("timeshift_buffer_size", m_timeshiftBufferSize);
+  UPDATE_INT("timeshift_memory_size", m_timeshiftMemorySize);
+  UPDATE_BOOL("timeshift_low_latency", m_timeshiftLowLatency);
 
   return ADDON_STATUS_OK;
 #undef UPDATE_BOOL
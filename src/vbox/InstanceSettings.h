@@ -22,6 +22,13 @@ namespace vbox
     CH_ORDER_BY_INDEX
   };
 
+  enum TimeshiftBufferType
+  {
+    TIMESHIFT_BUFFER_FILESYSTEM = 0,
+    TIMESHIFT_BUFFER_MEMORY,
+    TIMESHIFT_BUFFER_TIERED
+  };
+
   /**
    * Represents a set of parameters required to make a connection
    */
@@ -80,8 +87,13 @@ namespace vbox
     ConnectionParameters m_internalConnectionParams;
     ConnectionParameters m_externalConnectionParams;
     ChannelOrder m_setChannelIdUsingOrder;
+    int m_guideFetchConcurrency;
     bool m_timeshiftEnabled;
+    TimeshiftBufferType m_timeshiftBufferType;
     std::string m_timeshiftBufferPath;
+    int m_timeshiftBufferSize;
+    int m_timeshiftMemorySize;
+    bool m_timeshiftLowLatency;
 
   private:
     InstanceSettings(const InstanceSettings&) = delete;
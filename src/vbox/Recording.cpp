@@ -13,7 +13,13 @@
 using namespace vbox;
 
 Recording::Recording(const std::string& channelId, const std::string& channelName, RecordingState state)
-  : m_id(0), m_seriesId(0), m_channelId(channelId), m_channelName(channelName), m_state(state)
+  : m_id(0),
+    m_seriesId(0),
+    m_channelId(channelId),
+    m_channelName(channelName),
+    m_startTimestamp(0),
+    m_endTimestamp(0),
+    m_state(state)
 {
 }
 
@@ -23,13 +29,11 @@ Recording::~Recording()
 
 bool Recording::IsRunning(const std::time_t now, const std::string& channelName, std::time_t startTime) const
 {
-  time_t timerStartTime = xmltv::Utilities::XmltvToUnixTime(m_startTime);
-  time_t timerEndTime = xmltv::Utilities::XmltvToUnixTime(m_endTime);
-  if (!(timerStartTime <= now && now <= timerEndTime))
+  if (!(m_startTimestamp <= now && now <= m_endTimestamp))
     return false;
   if (!channelName.empty() && m_channelName != channelName)
     return false;
-  if (timerStartTime != startTime)
+  if (m_startTimestamp != startTime)
     return false;
   return true;
 }
@@ -28,7 +28,7 @@ namespace vbox
   };
 
   class Recording;
-  typedef std::unique_ptr<Recording> RecordingPtr;
+  typedef std::shared_ptr<Recording> RecordingPtr;
 
   /**
    * Represents a recording
@@ -98,6 +98,14 @@ namespace vbox
     std::string m_description;
     std::string m_startTime;
     std::string m_endTime;
+
+    /**
+     * The start and end times as Unix timestamps, must be kept in sync with
+     * m_startTime and m_endTime
+     */
+    time_t m_startTimestamp;
+    time_t m_endTimestamp;
+
     int m_duration;
 
   private:
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "RequestMetrics.h"
+
+#include <cmath>
+
+#include <kodi/General.h>
+
+using namespace vbox;
+
+void LatencyHistogram::Add(std::chrono::steady_clock::duration latency)
+{
+  auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(latency).count();
+  size_t bucket = 0;
+
+  while (bucket < NUM_BUCKETS - 1 && milliseconds > GetBucketLimit(bucket))
+    bucket++;
+
+  m_buckets[bucket]++;
+  m_count++;
+}
+
+unsigned int LatencyHistogram::GetPercentile(unsigned int percentile) const
+{
+  if (m_count == 0)
+    return 0;
+
+  // The rank of the sample we're looking for, rounded up
+  unsigned int rank = (m_count * percentile + 99) / 100;
+  unsigned int seen = 0;
+
+  for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+  {
+    seen += m_buckets[bucket];
+
+    if (seen >= rank && seen > 0)
+      return GetBucketLimit(bucket);
+  }
+
+  return GetBucketLimit(NUM_BUCKETS - 1);
+}
+
+unsigned int LatencyHistogram::GetBucketLimit(size_t bucket)
+{
+  // Four buckets per doubling
+  return static_cast<unsigned int>(std::lround(std::pow(2.0, bucket / 4.0)));
+}
+
+void RequestMetrics::Record(const std::string& identifier, bool successful, size_t bytesReceived,
+                            std::chrono::steady_clock::duration transferTime,
+                            std::chrono::steady_clock::duration parseTime)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  MethodMetrics& metrics = m_methods[identifier];
+
+  metrics.count++;
+  metrics.bytesReceived += bytesReceived;
+  metrics.transferTime.Add(transferTime);
+  metrics.parseTime.Add(parseTime);
+
+  if (!successful)
+    metrics.errors++;
+}
+
+void RequestMetrics::LogStatistics(ADDON_LOG level) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  kodi::Log(level, "Request statistics (latencies in ms as p50/p95/p99):");
+
+  for (const auto& entry : m_methods)
+  {
+    const MethodMetrics& metrics = entry.second;
+
+    kodi::Log(level, "    %s: %u requests, %u errors, %llu bytes, transfer %u/%u/%u, parse %u/%u/%u",
+              entry.first.c_str(), metrics.count, metrics.errors,
+              static_cast<unsigned long long>(metrics.bytesReceived), metrics.transferTime.GetPercentile(50),
+              metrics.transferTime.GetPercentile(95), metrics.transferTime.GetPercentile(99),
+              metrics.parseTime.GetPercentile(50), metrics.parseTime.GetPercentile(95),
+              metrics.parseTime.GetPercentile(99));
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <kodi/AddonBase.h>
+
+namespace vbox
+{
+
+  /**
+   * A latency histogram with exponentially growing buckets, from 1 ms up to
+   * about 55 seconds. Percentiles are reported as the upper bound of the
+   * bucket they fall in, which is accurate to within 20 %
+   */
+  class LatencyHistogram
+  {
+  public:
+    void Add(std::chrono::steady_clock::duration latency);
+
+    /**
+     * @param percentile the percentile (0-100)
+     * @return the latency in milliseconds, or 0 if nothing has been recorded
+     */
+    unsigned int GetPercentile(unsigned int percentile) const;
+
+  private:
+    static const size_t NUM_BUCKETS = 64;
+
+    static unsigned int GetBucketLimit(size_t bucket);
+
+    std::array<unsigned int, NUM_BUCKETS> m_buckets{};
+    unsigned int m_count = 0;
+  };
+
+  /**
+   * Collects statistics about the requests made to the gateway, per API
+   * method
+   */
+  class RequestMetrics
+  {
+  public:
+    /**
+     * Records a completed request
+     * @param identifier the request identifier (usually the API method)
+     * @param successful whether the request succeeded
+     * @param bytesReceived the size of the response
+     * @param transferTime the time spent waiting for and reading the response
+     * @param parseTime the time spent parsing the response
+     */
+    void Record(const std::string& identifier, bool successful, size_t bytesReceived,
+                std::chrono::steady_clock::duration transferTime,
+                std::chrono::steady_clock::duration parseTime);
+
+    /**
+     * Logs the statistics of every method that has been called
+     * @param level the log level to use
+     */
+    void LogStatistics(ADDON_LOG level) const;
+
+  private:
+    struct MethodMetrics
+    {
+      unsigned int count = 0;
+      unsigned int errors = 0;
+      uint64_t bytesReceived = 0;
+      LatencyHistogram transferTime;
+      LatencyHistogram parseTime;
+    };
+
+    std::map<std::string, MethodMetrics> m_methods;
+    mutable std::mutex m_mutex;
+  };
+} // namespace vbox
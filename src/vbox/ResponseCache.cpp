@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "ResponseCache.h"
+
+#include <kodi/General.h>
+
+using namespace vbox;
+
+ResponseCache::ResponseCache(const std::map<std::string, std::chrono::seconds>& lifetimes)
+  : m_lifetimes(lifetimes), m_epoch(0), m_hits(0), m_misses(0)
+{
+}
+
+response::ResponsePtr ResponseCache::Get(const std::string& method, const std::string& location)
+{
+  if (m_lifetimes.find(method) == m_lifetimes.end())
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(location);
+
+  if (it != m_entries.end())
+  {
+    if (std::chrono::steady_clock::now() < it->second.expires)
+    {
+      m_hits++;
+      return it->second.response;
+    }
+
+    m_entries.erase(it);
+  }
+
+  m_misses++;
+  return nullptr;
+}
+
+void ResponseCache::Put(const std::string& method, const std::string& location, const response::ResponsePtr& response,
+                        unsigned int epoch)
+{
+  auto lifetime = m_lifetimes.find(method);
+  if (lifetime == m_lifetimes.end())
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // The response may have been produced before the cache was last cleared
+  if (epoch != m_epoch.load())
+    return;
+
+  m_entries[location] = {response, std::chrono::steady_clock::now() + lifetime->second};
+}
+
+void ResponseCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_epoch++;
+}
+
+void ResponseCache::LogStatistics(ADDON_LOG level) const
+{
+  kodi::Log(level, "Response cache: %u hits, %u misses", m_hits.load(), m_misses.load());
+}
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "response/Response.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <kodi/AddonBase.h>
+
+namespace vbox
+{
+
+  /**
+   * Caches the responses of cheap, read-only API methods for a method
+   * specific amount of time
+   */
+  class ResponseCache
+  {
+  public:
+    /**
+     * @param lifetimes how long the responses of each cacheable method stay
+     * valid. Responses of other methods are never cached
+     */
+    explicit ResponseCache(const std::map<std::string, std::chrono::seconds>& lifetimes);
+    ~ResponseCache() = default;
+
+    /**
+     * @param method the API method
+     * @param location the request location
+     * @return the cached response, or nullptr if there is none
+     */
+    response::ResponsePtr Get(const std::string& method, const std::string& location);
+
+    /**
+     * Caches the response if the method is cacheable and the cache hasn't
+     * been cleared since the request was started
+     * @param method the API method
+     * @param location the request location
+     * @param response the response
+     * @param epoch the epoch at the time the request was started
+     */
+    void Put(const std::string& method, const std::string& location, const response::ResponsePtr& response,
+             unsigned int epoch);
+
+    /**
+     * Removes all cached responses and starts a new epoch
+     */
+    void Clear();
+
+    /**
+     * @return the current epoch. Capture it before performing a request and
+     * pass it to Put() so that responses which may predate a Clear() are
+     * never cached
+     */
+    unsigned int GetEpoch() const { return m_epoch.load(); }
+
+    /**
+     * Logs the hit and miss counters
+     * @param level the log level to use
+     */
+    void LogStatistics(ADDON_LOG level) const;
+
+  private:
+    struct Entry
+    {
+      response::ResponsePtr response;
+      std::chrono::steady_clock::time_point expires;
+    };
+
+    const std::map<std::string, std::chrono::seconds> m_lifetimes;
+    std::map<std::string, Entry> m_entries;
+    std::mutex m_mutex;
+
+    std::atomic<unsigned int> m_epoch;
+    std::atomic<unsigned int> m_hits;
+    std::atomic<unsigned int> m_misses;
+  };
+} // namespace vbox
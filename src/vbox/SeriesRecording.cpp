@@ -11,6 +11,12 @@
 using namespace vbox;
 
 SeriesRecording::SeriesRecording(const std::string& channelId)
-  : m_id(0), m_scheduledId(0), m_channelId(channelId), m_fIsAuto(false), m_weekdays(0)
+  : m_id(0),
+    m_scheduledId(0),
+    m_channelId(channelId),
+    m_fIsAuto(false),
+    m_startTimestamp(0),
+    m_endTimestamp(0),
+    m_weekdays(0)
 {
 }
\ No newline at end of file
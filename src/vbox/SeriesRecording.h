@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <ctime>
 #include <memory>
 #include <string>
 
@@ -15,7 +16,7 @@ namespace vbox
 {
 
   class SeriesRecording;
-  typedef std::unique_ptr<SeriesRecording> SeriesRecordingPtr;
+  typedef std::shared_ptr<SeriesRecording> SeriesRecordingPtr;
 
   /**
   * Represents a series
@@ -50,6 +51,14 @@ namespace vbox
     bool m_fIsAuto;
     std::string m_startTime;
     std::string m_endTime;
+
+    /**
+     * The start and end times as Unix timestamps, must be kept in sync with
+     * m_startTime and m_endTime
+     */
+    time_t m_startTimestamp;
+    time_t m_endTimestamp;
+
     unsigned int m_weekdays;
   };
 
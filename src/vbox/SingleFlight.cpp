@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "SingleFlight.h"
+
+using namespace vbox;
+
+response::ResponsePtr SingleFlight::Perform(const std::string& key,
+                                            const std::function<response::ResponsePtr()>& perform)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // Wait for the call that is already in flight
+  auto it = m_calls.find(key);
+  if (it != m_calls.end())
+  {
+    std::shared_future<response::ResponsePtr> future = it->second;
+    lock.unlock();
+
+    m_sharedCalls++;
+    return future.get();
+  }
+
+  std::promise<response::ResponsePtr> promise;
+  std::shared_future<response::ResponsePtr> future = promise.get_future().share();
+  m_calls[key] = future;
+  lock.unlock();
+
+  try
+  {
+    promise.set_value(perform());
+  }
+  catch (...)
+  {
+    promise.set_exception(std::current_exception());
+  }
+
+  lock.lock();
+  m_calls.erase(key);
+  lock.unlock();
+
+  return future.get();
+}
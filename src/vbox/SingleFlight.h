@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "response/Response.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace vbox
+{
+
+  /**
+   * Makes concurrent callers of the same request share a single call. The
+   * first caller performs the request, the others wait for it and receive the
+   * same response (or exception).
+   */
+  class SingleFlight
+  {
+  public:
+    SingleFlight() : m_sharedCalls(0) {}
+    ~SingleFlight() = default;
+
+    /**
+     * Performs the call identified by the key, unless an identical call is
+     * already in flight in which case its result is returned instead
+     * @param key identifies the call
+     * @param perform performs the call
+     * @return the response
+     */
+    response::ResponsePtr Perform(const std::string& key, const std::function<response::ResponsePtr()>& perform);
+
+    /**
+     * @return the number of callers that shared another caller's call
+     */
+    unsigned int GetSharedCalls() const { return m_sharedCalls; }
+
+  private:
+    std::map<std::string, std::shared_future<response::ResponsePtr>> m_calls;
+    std::mutex m_mutex;
+    std::atomic<unsigned int> m_sharedCalls;
+  };
+} // namespace vbox
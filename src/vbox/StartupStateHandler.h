@@ -12,6 +12,8 @@
 #include <condition_variable>
 #include <mutex>
 
+#include <kodi/General.h>
+
 namespace vbox
 {
 
@@ -39,11 +41,15 @@ namespace vbox
     /**
       * Initializes the handler. The state is set to UNINITIALIZED by default.
       */
-    StartupStateHandler() : m_state(StartupState::UNINITIALIZED) {}
+    StartupStateHandler()
+      : m_state(StartupState::UNINITIALIZED), m_startTime(std::chrono::steady_clock::now()), m_gatewayAvailable(true)
+    {
+    }
     ~StartupStateHandler(){};
 
     /**
-      * Waits for the specified state.
+      * Waits for the specified state. Returns immediately if the gateway is
+      * known to be unavailable.
       *
       * @param state the desired state
       * @return whether the state was reached before the timeout
@@ -56,12 +62,29 @@ namespace vbox
       m_condition.wait_for(lock, std::chrono::seconds(STATE_WAIT_TIMEOUT),
                            [this, state]()
                            {
-                             return m_state >= state;
+                             return m_state >= state || !m_gatewayAvailable;
                            });
 
+      if (m_state < state && !m_gatewayAvailable)
+        kodi::Log(ADDON_LOG_DEBUG, "Not waiting for startup state %s, the gateway is not responding",
+                  GetStateName(state));
+
       return m_state >= state;
     }
 
+    /**
+      * Sets whether the gateway is responding. Waiting for a state is pointless
+      * while it isn't, so all waiters are woken up
+      *
+      * @param available whether the gateway is available
+      */
+    void SetGatewayAvailable(bool available)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_gatewayAvailable = available;
+      m_condition.notify_all();
+    }
+
     /**
       * Enters the specified state
       *
@@ -72,6 +95,11 @@ namespace vbox
       std::unique_lock<std::mutex> lock(m_mutex);
       m_state = state;
 
+      // Log how long startup took so far, to be able to compare gateways
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime);
+      kodi::Log(ADDON_LOG_INFO, "Entered startup state %s after %d ms", GetStateName(state),
+                static_cast<int>(elapsed.count()));
+
       // Notify all waiters
       m_condition.notify_all();
     }
@@ -88,6 +116,30 @@ namespace vbox
     }
 
   private:
+    /**
+     * @return the name of the specified state
+     */
+    static const char* GetStateName(StartupState state)
+    {
+      switch (state)
+      {
+        case StartupState::UNINITIALIZED:
+          return "UNINITIALIZED";
+        case StartupState::INITIALIZED:
+          return "INITIALIZED";
+        case StartupState::CHANNELS_LOADED:
+          return "CHANNELS_LOADED";
+        case StartupState::RECORDINGS_LOADED:
+          return "RECORDINGS_LOADED";
+        case StartupState::GUIDE_LOADED:
+          return "GUIDE_LOADED";
+        case StartupState::EXTERNAL_GUIDE_LOADED:
+          return "EXTERNAL_GUIDE_LOADED";
+      }
+
+      return "UNKNOWN";
+    }
+
     /**
      * The maximum amount of seconds to block while waiting for a state
      * change
@@ -99,6 +151,16 @@ namespace vbox
       */
     StartupState m_state;
 
+    /**
+      * When the handler was created, i.e. when startup began
+      */
+    std::chrono::steady_clock::time_point m_startTime;
+
+    /**
+      * Whether the gateway is responding to requests
+      */
+    bool m_gatewayAvailable;
+
     /**
       * Mutex for m_state
       */
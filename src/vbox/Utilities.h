@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
 
 #include <kodi/Filesystem.h>
 
@@ -35,20 +36,37 @@ namespace utilities
 
   /**
    * Reads the contents of the file pointed to by the handle and returns it.
-   * The file handle must be opened before calling this method.
+   * The file handle must be opened before calling this method. The data is
+   * read in large chunks directly into the string, which is sized up front
+   * when the length of the file is known.
    * @param fileHandle the file handle
    * @return the contents (unique pointer)
    */
   inline std::unique_ptr<std::string> ReadFileContents(kodi::vfs::CFile& fileHandle)
   {
+    const size_t chunkSize = 65536;
     std::unique_ptr<std::string> content(new std::string());
 
-    char buffer[1024];
-    int bytesRead = 0;
+    // The length is known for local files and HTTP responses with a
+    // Content-Length header. Leave room for the final, empty read
+    int64_t length = fileHandle.GetLength();
+    if (length > 0)
+      content->reserve(static_cast<size_t>(length) + chunkSize);
+
+    size_t size = 0;
+    ssize_t bytesRead = 0;
 
     // Read until EOF or explicit error
-    while ((bytesRead = fileHandle.Read(buffer, sizeof(buffer) - 1)) > 0)
-      content->append(buffer, bytesRead);
+    do
+    {
+      content->resize(size + chunkSize);
+      bytesRead = fileHandle.Read(&(*content)[size], chunkSize);
+
+      if (bytesRead > 0)
+        size += static_cast<size_t>(bytesRead);
+    } while (bytesRead > 0);
+
+    content->resize(size);
 
     return content;
   }
@@ -8,6 +8,7 @@
 
 #include "VBox.h"
 
+#include "../xmltv/GuideReader.h"
 #include "../xmltv/Utilities.h"
 #include "ContentIdentifier.h"
 #include "Exceptions.h"
@@ -20,6 +21,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <future>
+#include <random>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -31,14 +35,62 @@ const char* VBox::MINIMUM_SOFTWARE_VERSION = "2.48";
 const time_t STREAMING_STATUS_UPDATE_INTERVAL = 10;
 const int CHANNELS_PER_CHANNELBATCH = 100;
 const int CHANNELS_PER_EPGBATCH = 10;
+const int MIN_CHANNELS_PER_CHANNELBATCH = 10;
+const int MAX_CHANNELS_PER_CHANNELBATCH = 500;
+const int MIN_CHANNELS_PER_EPGBATCH = 1;
+const int MAX_CHANNELS_PER_EPGBATCH = 50;
+const size_t TARGET_BATCH_RESPONSE_SIZE = 1024 * 1024;
+const std::chrono::milliseconds TARGET_BATCH_RESPONSE_TIME(3000);
 const size_t VBOX_LOG_BUFFER = 16384;
+const size_t GUIDE_READ_CHUNK_SIZE = 32768;
+const std::chrono::milliseconds CONNECTION_PROBE_HEAD_START(300);
+const unsigned int CONNECTION_FAILURE_THRESHOLD = 3;
+const unsigned int CONNECTION_CACHE_FORMAT_VERSION = 1;
+const int HTTP_CONNECTION_POOL_SIZE = 4;
+const unsigned int MAX_REQUEST_ATTEMPTS = 3;
+const std::chrono::milliseconds RETRY_BASE_DELAY(500);
+const std::chrono::milliseconds RETRY_MAX_DELAY(4000);
+const unsigned int CIRCUIT_FAILURE_THRESHOLD = 5;
+const std::chrono::milliseconds CIRCUIT_OPEN_DURATION(10000);
+const std::chrono::milliseconds CIRCUIT_MAX_OPEN_DURATION(120000);
+
+// How long the responses of cheap read-only methods may be reused. Every
+// mutating request clears the cache
+const std::map<std::string, std::chrono::seconds> RESPONSE_CACHE_LIFETIMES = {
+    {"QueryDataBaseVersion", std::chrono::seconds(5)},
+    {"GetRecordingsTimeOffset", std::chrono::seconds(600)},
+    {"QuerySwVersion", std::chrono::hours(24)},
+    {"QueryBoardInfo", std::chrono::hours(24)},
+};
 
 VBox::VBox()
-  : m_currentChannel(nullptr),
+  : m_channels(std::make_shared<ChannelList>()),
+    m_recordings(std::make_shared<RecordingList>()),
+    m_guide(std::make_shared<xmltv::Guide>()),
+    m_requestMetrics(std::make_shared<RequestMetrics>()),
+    m_circuitBreaker(CIRCUIT_FAILURE_THRESHOLD, CIRCUIT_OPEN_DURATION, CIRCUIT_MAX_OPEN_DURATION),
+    m_mutationGeneration(0),
+    m_responseCache(RESPONSE_CACHE_LIFETIMES),
     m_categoryGenreMapper(nullptr),
+    m_channelBatchSize("Channel list", CHANNELS_PER_CHANNELBATCH, MIN_CHANNELS_PER_CHANNELBATCH,
+                       MAX_CHANNELS_PER_CHANNELBATCH, TARGET_BATCH_RESPONSE_SIZE, TARGET_BATCH_RESPONSE_TIME),
+    m_guideBatchSize("Guide section", CHANNELS_PER_EPGBATCH, MIN_CHANNELS_PER_EPGBATCH,
+                     MAX_CHANNELS_PER_EPGBATCH, TARGET_BATCH_RESPONSE_SIZE, TARGET_BATCH_RESPONSE_TIME),
+    m_lastStreamStatus({ChannelStreamingStatus(), time(nullptr)}),
     m_shouldSyncEpg(false),
-    m_lastStreamStatus({ChannelStreamingStatus(), time(nullptr)})
+    m_currentChannel(nullptr)
 {
+  // Don't make callers wait for startup states that won't be reached while
+  // the gateway is unresponsive
+  m_circuitBreaker.OnStateChanged = [this](CircuitState state)
+  {
+    if (state == CircuitState::OPEN)
+      kodi::Log(ADDON_LOG_WARNING, "The gateway is not responding, pausing requests");
+    else
+      kodi::Log(ADDON_LOG_INFO, "The gateway is responding again, resuming requests");
+
+    m_stateHandler.SetGatewayAvailable(state != CircuitState::OPEN);
+  };
 }
 
 VBox::~VBox()
@@ -48,21 +100,46 @@ VBox::~VBox()
 
   if (m_backgroundThread.joinable())
     m_backgroundThread.join();
+
+  JoinConnectionProbes();
 }
 
 void VBox::Initialize()
 {
-  // Determine which connection parameters should be used
-  DetermineConnectionParams();
-
-  // Query the software version, we need a few elements from that response
-  request::ApiRequest versionRequest("QuerySwVersion", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-  response::ResponsePtr response = PerformRequest(versionRequest);
+  // Leave room for the concurrent guide requests plus one other request
+  m_connectionPool = std::make_shared<HttpConnectionPool>(
+      std::max(HTTP_CONNECTION_POOL_SIZE, m_settings->m_guideFetchConcurrency + 1));
+
+  // The cached connection choice, channels and guide are stored per gateway
+  std::string gatewayId = m_settings->m_internalConnectionParams.GetUriAuthority();
+  m_connectionCache.reset(new CacheFile("connection", CONNECTION_CACHE_FORMAT_VERSION, gatewayId));
+  m_channelCache.reset(new ChannelCache(gatewayId));
+  m_guideCache.reset(new GuideCache(gatewayId));
+
+  // Determine which connection parameters should be used. The software
+  // version response used for probing is needed below too
+  response::ResponsePtr response = DetermineConnectionParams();
   response::Content versionContent(response->GetReplyElement());
 
+  // The remaining queries don't depend on each other, run them concurrently
+  auto performAsync = [this](const std::string& method, const std::string& parameter = "", const std::string& value = "")
+  {
+    return std::async(std::launch::async, [this, method, parameter, value]()
+    {
+      request::ApiRequest request(method, GetConnectionParams().hostname, GetConnectionParams().upnpPort);
+      if (!parameter.empty())
+        request.AddParameter(parameter, value);
+
+      return PerformRequest(request);
+    });
+  };
+
+  auto boardFuture = performAsync("QueryBoardInfo");
+  auto mediaFuture = performAsync("QueryExternalMediaStatus");
+  auto timezoneFuture = performAsync("QuerySystemTime", "TimeFormat", "XMLTV");
+
   // Query the board info, we need some elements from that as well
-  request::ApiRequest boardRequest("QueryBoardInfo", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-  response::ResponsePtr boardResponse = PerformRequest(boardRequest);
+  response::ResponsePtr boardResponse = boardFuture.get();
   response::Content boardInfo(boardResponse->GetReplyElement());
 
   // Construct the model string
@@ -95,8 +172,7 @@ void VBox::Initialize()
   // is attached
   try
   {
-    request::ApiRequest mediaRequest("QueryExternalMediaStatus", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-    response::ResponsePtr mediaResponse = PerformRequest(mediaRequest);
+    response::ResponsePtr mediaResponse = mediaFuture.get();
     response::Content mediaStatus = response::Content(mediaResponse->GetReplyElement());
 
     ExternalMediaStatus externalMediaStatus;
@@ -112,9 +188,7 @@ void VBox::Initialize()
   }
 
   // Query the timezone offset used
-  request::ApiRequest timezoneRequest("QuerySystemTime", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-  timezoneRequest.AddParameter("TimeFormat", "XMLTV");
-  response::ResponsePtr timezoneResponse = PerformRequest(timezoneRequest);
+  response::ResponsePtr timezoneResponse = timezoneFuture.get();
   response::Content timezoneInfo(timezoneResponse->GetReplyElement());
 
   std::string timestamp = timezoneInfo.GetString("Time");
@@ -123,7 +197,9 @@ void VBox::Initialize()
   // Consider the addon initialized
   m_stateHandler.EnterState(StartupState::INITIALIZED);
 
-  RetrieveChannels(false);
+  // Use the cached channels if possible. Either way the background updater
+  // retrieves them from the backend, until then GetChannels() waits
+  LoadCachedChannels();
 
   // Start the background updater thread
   m_active = true;
@@ -133,32 +209,108 @@ void VBox::Initialize()
   });
 }
 
-void VBox::DetermineConnectionParams()
+response::ResponsePtr VBox::DetermineConnectionParams()
 {
-  // Attempt to perform a request using the internal connection parameters
-  m_currentConnectionParameters = m_settings->m_internalConnectionParams;
+  // Make sure the probes of a previous attempt have finished
+  JoinConnectionProbes();
 
-  try
+  std::vector<ConnectionParameters> candidates = {m_settings->m_internalConnectionParams};
+
+  // Probe both endpoints when there are two of them, starting with the one
+  // that answered first last time
+  if (m_settings->m_externalConnectionParams.AreValid())
   {
-    request::ApiRequest request("QuerySwVersion", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-    request.SetTimeout(m_currentConnectionParameters.timeout);
-    PerformRequest(request);
+    candidates.push_back(m_settings->m_externalConnectionParams);
+
+    if (LoadPreferredConnection() == candidates[1].GetUriAuthority())
+      std::swap(candidates[0], candidates[1]);
   }
-  catch (VBoxException&)
+
+  // Each probe waits until it's given a head start, or the ones before it have
+  // failed, then reports its outcome. The probes don't reference this object
+  // so the race can be decided before the losers have timed out
+  auto race = std::make_shared<ConnectionRace>();
+  auto pool = m_connectionPool;
+  auto metrics = m_requestMetrics;
+
+  for (size_t i = 0; i < candidates.size(); i++)
   {
-    // Retry the request with the external parameters
-    if (m_settings->m_externalConnectionParams.AreValid())
+    m_connectionProbes.emplace_back([race, pool, metrics, i, params = candidates[i]]()
     {
-      kodi::Log(ADDON_LOG_INFO, "Unable to connect using internal connection settings, trying with external");
-      m_currentConnectionParameters = m_settings->m_externalConnectionParams;
+      {
+        std::unique_lock<std::mutex> lock(race->mutex);
+        race->condition.wait_for(lock, CONNECTION_PROBE_HEAD_START * i, [&race, i]()
+        {
+          return race->winner >= 0 || race->failed >= i;
+        });
 
-      request::ApiRequest request("QuerySwVersion", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-      request.SetTimeout(m_currentConnectionParameters.timeout);
-      PerformRequest(request);
-    }
+        if (race->winner >= 0)
+          return;
+      }
+
+      response::ResponsePtr response;
+      std::exception_ptr error;
+
+      try
+      {
+        request::ApiRequest request("QuerySwVersion", params.hostname, params.upnpPort);
+        request.SetTimeout(params.timeout);
+        response = PerformRequest(request, params, *pool, *metrics);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+
+      std::unique_lock<std::mutex> lock(race->mutex);
+
+      if (response && race->winner < 0)
+      {
+        race->winner = static_cast<int>(i);
+        race->response = std::move(response);
+      }
+      else if (!response)
+      {
+        race->failed++;
+
+        if (!race->error)
+          race->error = error;
+      }
+
+      race->condition.notify_all();
+    });
   }
 
-  auto& params = m_currentConnectionParameters;
+  std::unique_lock<std::mutex> lock(race->mutex);
+  race->condition.wait(lock, [&race, &candidates]()
+  {
+    return race->winner >= 0 || race->failed == candidates.size();
+  });
+
+  // Report the first failure when neither endpoint answered
+  if (race->winner < 0)
+    std::rethrow_exception(race->error);
+
+  size_t winner = static_cast<size_t>(race->winner);
+  response::ResponsePtr response = std::move(race->response);
+  lock.unlock();
+
+  const ConnectionParameters& params = candidates[winner];
+
+  if (winner > 0)
+    kodi::Log(ADDON_LOG_INFO, "Unable to connect using the preferred connection settings, using the other ones");
+
+  {
+    std::lock_guard<std::mutex> connectionLock(m_connectionMutex);
+    m_currentConnectionParameters = params;
+  }
+
+  m_consecutiveFailures = 0;
+  m_circuitBreaker.RecordSuccess();
+
+  if (candidates.size() > 1)
+    SavePreferredConnection(params.GetUriAuthority());
+
   kodi::Log(ADDON_LOG_INFO, "Connection parameters used: ");
   kodi::Log(ADDON_LOG_INFO, "    Hostname: %s", params.hostname.c_str());
 
@@ -168,6 +320,58 @@ void VBox::DetermineConnectionParams()
     kodi::Log(ADDON_LOG_INFO, "    HTTP port: %d", params.httpPort);
 
   kodi::Log(ADDON_LOG_INFO, "    UPnP port: %d", params.upnpPort);
+
+  return response;
+}
+
+void VBox::JoinConnectionProbes()
+{
+  for (auto& probe : m_connectionProbes)
+  {
+    if (probe.joinable())
+      probe.join();
+  }
+
+  m_connectionProbes.clear();
+}
+
+std::string VBox::LoadPreferredConnection() const
+{
+  unsigned int unused;
+  std::unique_ptr<CacheReader> reader = m_connectionCache->Open(unused);
+
+  if (!reader)
+    return "";
+
+  std::string authority = reader->ReadString();
+  return reader->IsValid() ? authority : "";
+}
+
+void VBox::SavePreferredConnection(const std::string& authority) const
+{
+  if (LoadPreferredConnection() == authority)
+    return;
+
+  CacheWriter writer = m_connectionCache->CreateWriter(0);
+  writer.WriteString(authority);
+  m_connectionCache->Save(writer);
+}
+
+void VBox::ReevaluateConnectionParams()
+{
+  kodi::Log(ADDON_LOG_INFO, "%d consecutive requests have failed, re-evaluating the connection parameters",
+            m_consecutiveFailures.load());
+
+  try
+  {
+    DetermineConnectionParams();
+  }
+  catch (VBoxException& e)
+  {
+    // Keep the current parameters and try again after more failures
+    LogException(e);
+    m_consecutiveFailures = 0;
+  }
 }
 
 void VBox::InitScanningEPG(std::string& rScanMethod, std::string& rGetStatusMethod, std::string& rfIsScanningFlag)
@@ -226,12 +430,30 @@ void VBox::BackgroundUpdater()
   // tasks only on some iterations
   static unsigned int lapCounter = 1;
 
+  // Publish the cached guide as soon as there are channels, so that it
+  // doesn't have to wait for any requests when the channels came from the
+  // cache
+  bool cachedChannels = m_stateHandler.GetState() >= StartupState::CHANNELS_LOADED;
+
+  if (cachedChannels)
+    LoadCachedGuide();
+
   // Retrieve everything in order once before starting the loop, without
-  // triggering the event handlers
-  RetrieveChannels(false);
+  // triggering the event handlers. The exception is the channel list, which
+  // may have been loaded from the cache and be outdated
+  RetrieveChannels();
+
+  if (!cachedChannels)
+    LoadCachedGuide();
 
   InitializeGenreMapper();
   RetrieveRecordings(false);
+
+  // The startup states are entered in order, so a cached guide can only
+  // enter its state once the recordings have been retrieved
+  if (m_cachedGuideLoaded && m_stateHandler.GetState() < StartupState::GUIDE_LOADED)
+    m_stateHandler.EnterState(StartupState::GUIDE_LOADED);
+
   RetrieveGuide(false);
 
   // Whether or not initial EPG updates occurred now Trigger "Real" EPG updates
@@ -240,14 +462,47 @@ void VBox::BackgroundUpdater()
 
   while (m_active)
   {
-    // Update recordings every 12 iterations = 1 minute
-    if (lapCounter % 12 == 0)
-      RetrieveRecordings();
+    // Switch endpoints if the current one has stopped answering
+    if (m_consecutiveFailures >= CONNECTION_FAILURE_THRESHOLD && m_settings->m_externalConnectionParams.AreValid())
+      ReevaluateConnectionParams();
+
+    // Poll the database versions every six iterations = 30 seconds. The
+    // response is shared by all the checks below (and by the Retrieve*()
+    // methods through the response cache), and only what changed is
+    // refreshed
+    bool polled = lapCounter % 6 == 0;
+    DatabaseVersions versions;
+
+    if (polled)
+    {
+      try
+      {
+        versions = GetDBVersions();
+      }
+      catch (VBoxException& e)
+      {
+        LogException(e);
+        polled = false;
+      }
+    }
 
-    // Update channels every six iterations = 30 seocnds
-    if (lapCounter % 6 == 0)
+    if (polled && versions.channels != m_channelsDBVersion)
       RetrieveChannels();
 
+    // Without a records database version, update the recordings every 12
+    // iterations = 1 minute
+    bool recordingsChanged = versions.hasRecords ? polled && versions.records != m_recordsDBVersion
+                                                 : lapCounter % 12 == 0;
+
+    // Only consider this version handled once the recordings have been
+    // retrieved, otherwise try again on the next iteration
+    if (recordingsChanged && RetrieveRecordings())
+      m_recordsDBVersion = versions.records;
+
+    // Log the connection and request statistics every 12 * 10 iterations = 10 minutes
+    if (lapCounter % (12 * 10) == 0)
+      LogRequestStatistics(ADDON_LOG_DEBUG);
+
     // if supposed to scan EPG - send scan API and get guide every 5 minutes, until done scanning
     if (m_epgScanState != EPGSCAN_NO_SCAN)
       UpdateEpgScan(lapCounter % (12 * 5) == 0);
@@ -257,8 +512,8 @@ void VBox::BackgroundUpdater()
       RetrieveGuide();
       m_shouldSyncEpg = false;
     }
-    // if not collecting/syncing user's EPG - update the internal guide data every 12 * 60 iterations = 1 hour
-    else if (lapCounter % (12 * 60) == 0)
+    // if not collecting/syncing user's EPG - update the internal guide data when it has changed
+    else if (polled && versions.programs != m_programsDBVersion)
       RetrieveGuide();
 
     lapCounter++;
@@ -268,16 +523,15 @@ void VBox::BackgroundUpdater()
 
 void VBox::TriggerEpgUpdatesForChannels()
 {
+  auto channelList = std::atomic_load(&m_channels);
+
+  for (auto& channel : channelList->channels)
   {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    for (auto& channel : m_channels)
-    {
-      kodi::Log(ADDON_LOG_DEBUG, "%s - Trigger EPG update for channel: %s (%s)", __FUNCTION__, channel->m_name.c_str(),
-          channel->m_uniqueId.c_str());
-    }
+    kodi::Log(ADDON_LOG_DEBUG, "%s - Trigger EPG update for channel: %s (%s)", __FUNCTION__, channel->m_name.c_str(),
+        channel->m_uniqueId.c_str());
   }
 
-  OnGuideUpdated();
+  OnGuideUpdated(channelList->channels);
 }
 
 bool VBox::ValidateSettings() const
@@ -294,8 +548,9 @@ bool VBox::ValidateSettings() const
   return true;
 }
 
-const ConnectionParameters& VBox::GetConnectionParams() const
+ConnectionParameters VBox::GetConnectionParams() const
 {
+  std::lock_guard<std::mutex> lock(m_connectionMutex);
   return m_currentConnectionParameters;
 }
 
@@ -314,7 +569,7 @@ std::string VBox::GetBackendName() const
 
 std::string VBox::GetBackendHostname() const
 {
-  return m_currentConnectionParameters.hostname;
+  return GetConnectionParams().hostname;
 }
 
 std::string VBox::GetBackendVersion() const
@@ -328,7 +583,8 @@ std::string VBox::GetBackendVersion() const
 std::string VBox::GetConnectionString() const
 {
   std::stringstream ss;
-  ss << GetBackendHostname() << ":" << m_currentConnectionParameters.httpPort;
+  ConnectionParameters params = GetConnectionParams();
+  ss << params.hostname << ":" << params.httpPort;
 
   return ss.str();
 }
@@ -336,34 +592,43 @@ std::string VBox::GetConnectionString() const
 int VBox::GetChannelsAmount() const
 {
   m_stateHandler.WaitForState(StartupState::CHANNELS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
 
-  return m_channels.size();
+  return std::atomic_load(&m_channels)->channels.size();
 }
 
-const std::vector<ChannelPtr>& VBox::GetChannels() const
+ChannelsPtr VBox::GetChannels() const
 {
   m_stateHandler.WaitForState(StartupState::CHANNELS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  auto channelList = std::atomic_load(&m_channels);
 
-  return m_channels;
+  // Share ownership of the snapshot so the vector stays valid
+  return ChannelsPtr(channelList, &channelList->channels);
 }
 
 const ChannelPtr VBox::GetChannel(unsigned int uniqueId) const
 {
   m_stateHandler.WaitForState(StartupState::CHANNELS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  auto channelList = std::atomic_load(&m_channels);
 
-  auto it = std::find_if(m_channels.cbegin(), m_channels.cend(),
-    [uniqueId](const ChannelPtr& channel) {
-      return uniqueId == ContentIdentifier::GetUniqueId(channel);
-    }
-  );
+  auto it = channelList->byUniqueId.find(uniqueId);
 
-  if (it == m_channels.cend())
+  if (it == channelList->byUniqueId.cend())
     return nullptr;
 
-  return *it;
+  return it->second;
+}
+
+const ChannelPtr VBox::GetChannelByXmltvName(const std::string& xmltvName) const
+{
+  m_stateHandler.WaitForState(StartupState::CHANNELS_LOADED);
+  auto channelList = std::atomic_load(&m_channels);
+
+  auto it = channelList->byXmltvName.find(xmltvName);
+
+  if (it == channelList->byXmltvName.cend())
+    return nullptr;
+
+  return it->second;
 }
 
 const ChannelPtr VBox::GetCurrentChannel() const
@@ -467,9 +732,9 @@ int64_t VBox::GetRecordingUsedSpace() const
 int VBox::GetRecordingsAmount() const
 {
   m_stateHandler.WaitForState(StartupState::RECORDINGS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  auto recordingList = std::atomic_load(&m_recordings);
 
-  return std::count_if(m_recordings.begin(), m_recordings.end(),
+  return std::count_if(recordingList->recordings.begin(), recordingList->recordings.end(),
                        [](const RecordingPtr& recording) { return recording->IsRecording(); });
 }
 
@@ -520,29 +785,34 @@ bool VBox::DeleteRecordingOrTimer(unsigned int id)
   // The request fails if the item doesn't exist
   try
   {
+    // Modify a copy of the current list and publish it once done
+    auto recordingList = std::make_shared<RecordingList>(*std::atomic_load(&m_recordings));
+    auto& recordings = recordingList->recordings;
+    auto& allSeries = recordingList->series;
+
     // Find the recording/timer - look for a single recording
-    auto it = std::find_if(m_recordings.begin(), m_recordings.end(), [id](const RecordingPtr& recording) { return id == recording->m_id; });
+    auto it = std::find_if(recordings.begin(), recordings.end(), [id](const RecordingPtr& recording) { return id == recording->m_id; });
 
     // if it matches a single recording - create and send delete request for recording
-    if (it != m_recordings.cend())
+    if (it != recordings.cend())
     {
       request::ApiRequest request = CreateDeleteRecordingRequest(*it);
       PerformRequest(request);
       // remove recording object from memory
-      m_recordings.erase(it);
+      recordings.erase(it);
     }
     // if id doesn't match a recording, it's a series
     else
     {
       // look for a series with that ID and throw exception if not found
-      auto seriesItr = std::find_if(m_series.begin(), m_series.end(), [id](const SeriesRecordingPtr& series) { return id == series->m_id; });
-      if (seriesItr != m_series.end())
+      auto seriesItr = std::find_if(allSeries.begin(), allSeries.end(), [id](const SeriesRecordingPtr& series) { return id == series->m_id; });
+      if (seriesItr != allSeries.end())
       {
         // create and send cancel request for that series recording
         request::ApiRequest request = CreateDeleteSeriesRequest(*seriesItr);
         PerformRequest(request);
         // remove series object from memory
-        m_series.erase(seriesItr);
+        allSeries.erase(seriesItr);
       }
       else
       {
@@ -550,6 +820,8 @@ bool VBox::DeleteRecordingOrTimer(unsigned int id)
       }
     }
 
+    std::atomic_store(&m_recordings, std::shared_ptr<const RecordingList>(recordingList));
+
     // Fire events
     OnRecordingsUpdated();
     OnTimersUpdated();
@@ -749,48 +1021,53 @@ void VBox::AddTimer(const ChannelPtr& channel,
 int VBox::GetTimersAmount() const
 {
   m_stateHandler.WaitForState(StartupState::RECORDINGS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  auto recordingList = std::atomic_load(&m_recordings);
 
-  int count = std::count_if(m_recordings.begin(), m_recordings.end(),
+  int count = std::count_if(recordingList->recordings.begin(), recordingList->recordings.end(),
                             [](const RecordingPtr& recording) { return recording->IsTimer(); });
-  count += m_series.size();
+  count += recordingList->series.size();
   return count;
 }
 
-const std::vector<RecordingPtr>& VBox::GetRecordingsAndTimers() const
+RecordingsPtr VBox::GetRecordingsAndTimers() const
 {
   m_stateHandler.WaitForState(StartupState::RECORDINGS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  auto recordingList = std::atomic_load(&m_recordings);
 
-  return m_recordings;
+  return RecordingsPtr(recordingList, &recordingList->recordings);
 }
 
-
-const std::vector<SeriesRecordingPtr>& VBox::GetSeriesTimers() const
+SeriesRecordingsPtr VBox::GetSeriesTimers() const
 {
   m_stateHandler.WaitForState(StartupState::RECORDINGS_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  auto recordingList = std::atomic_load(&m_recordings);
 
-  return m_series;
+  return SeriesRecordingsPtr(recordingList, &recordingList->series);
 }
 
 const Schedule VBox::GetSchedule(const ChannelPtr& channel) const
 {
-  // Load the schedule from the internal guide
-  m_stateHandler.WaitForState(StartupState::GUIDE_LOADED);
-  std::unique_lock<std::mutex> lock(m_mutex);
+  // Load the schedule from the internal guide. A guide loaded from the cache
+  // can be used right away
+  if (!m_cachedGuideLoaded)
+    m_stateHandler.WaitForState(StartupState::GUIDE_LOADED);
 
   Schedule schedule;
-  schedule.schedule = m_guide.GetSchedule(channel->m_xmltvName);
+  schedule.schedule = std::atomic_load(&m_guide)->GetSchedule(channel->m_xmltvName);
 
   return schedule;
 }
 
 std::string VBox::GetApiBaseUrl() const
+{
+  return GetApiBaseUrl(GetConnectionParams());
+}
+
+std::string VBox::GetApiBaseUrl(const ConnectionParameters& params)
 {
   std::stringstream ss;
-  ss << m_currentConnectionParameters.GetUriScheme() << "://";
-  ss << m_currentConnectionParameters.GetUriAuthority();
+  ss << params.GetUriScheme() << "://";
+  ss << params.GetUriAuthority();
   ss << "/cgi-bin/HttpControl/HttpControlApp?OPTION=1";
 
   return ss.str();
@@ -810,21 +1087,29 @@ std::string VBox::CreateDailyTime(const time_t unixTimestamp) const
   return ::xmltv::Utilities::UnixTimeToDailyTime(unixTimestamp, tzOffset);
 }
 
-unsigned int VBox::GetDBVersion(std::string& versionName) const
+DatabaseVersions VBox::GetDBVersions() const
 {
-  // get the backend's database version
+  // get the backend's database versions, all of them come in one response
   request::ApiRequest request("QueryDataBaseVersion", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
   response::ResponsePtr response = PerformRequest(request);
   response::Content content(response->GetReplyElement());
-  return content.GetUnsignedInteger(versionName);
+
+  DatabaseVersions versions;
+  versions.channels = content.GetUnsignedInteger("ChannelsDataBaseVersion");
+  versions.programs = content.GetUnsignedInteger("ProgramsDataBaseVersion");
+
+  // Not all firmware versions report the records database version
+  versions.hasRecords = !content.GetString("RecordsDataBaseVersion").empty();
+  versions.records = content.GetUnsignedInteger("RecordsDataBaseVersion");
+
+  return versions;
 }
 
 void VBox::RetrieveChannels(bool triggerEvent /* = true*/)
 {
   try
   {
-    std::string channelsDBVerName("ChannelsDataBaseVersion");
-    unsigned int newDBversion = GetDBVersion(channelsDBVerName);
+    unsigned int newDBversion = GetDBVersions().channels;
     // if same as last fetched channels, no need for fetching again
     if (newDBversion == m_channelsDBVersion)
       return;
@@ -837,20 +1122,22 @@ void VBox::RetrieveChannels(bool triggerEvent /* = true*/)
       response::Content content(response->GetReplyElement());
 
       // get number of channels from backend
-      std::unique_lock<std::mutex> lock(m_mutex);
       lastChannelIndex = content.GetUnsignedInteger("NumOfChannels");
     }
 
     std::vector<ChannelPtr> allChannels;
+    bool complete = true;
 
-    // Get channels in batches of 100
-    for (int fromIndex = 1; fromIndex <= lastChannelIndex; fromIndex += CHANNELS_PER_CHANNELBATCH)
+    // Get channels in batches, the batch size adapts to the response times
+    int toIndex;
+
+    for (int fromIndex = 1; fromIndex <= lastChannelIndex; fromIndex = toIndex + 1)
     {
       // Abort immediately if the addon just got terminated
       if (!m_active)
         return;
 
-      int toIndex = std::min(fromIndex + (CHANNELS_PER_CHANNELBATCH - 1), lastChannelIndex);
+      toIndex = std::min(fromIndex + (m_channelBatchSize.GetBatchSize() - 1), lastChannelIndex);
       // Swallow exceptions, we don't want channel loading to fail just because
       // one request failed
       try
@@ -858,30 +1145,56 @@ void VBox::RetrieveChannels(bool triggerEvent /* = true*/)
         request::ApiRequest request("GetXmltvChannelsList", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
         request.AddParameter("FromChIndex", fromIndex);
         request.AddParameter("ToChIndex", toIndex);
+
+        auto startTime = std::chrono::steady_clock::now();
         response::ResponsePtr response = PerformRequest(request);
+        m_channelBatchSize.AddSample(toIndex - fromIndex + 1, response->GetRawResponseSize(),
+                                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now() - startTime));
+
         response::XMLTVResponseContent content(response->GetReplyElement());
         auto channels = content.GetChannels();
 
+        // The indexes in the response are relative to the batch
+        for (auto& channel : channels)
+          channel->m_index += fromIndex - 1;
+
         // Add the batch to all channels
         allChannels.insert(allChannels.end(), channels.begin(), channels.end());
       }
       catch (VBoxException& e)
       {
         LogException(e);
+        complete = false;
       }
     }
 
+    m_channelBatchSize.LogStatistics(m_backendInformation.name);
+
+    // Only a complete list is remembered for the next startup. An incomplete
+    // one is still used, but the database version isn't advanced so that the
+    // next poll fetches the channels again
+    unsigned int dbVersion = newDBversion;
+
+    if (complete)
+      m_channelCache->Save(allChannels, newDBversion);
+    else
+    {
+      kodi::Log(ADDON_LOG_WARNING, "Some channels could not be retrieved, they will be fetched again later");
+      dbVersion = m_channelsDBVersion;
+    }
+
     // Swap and notify if the contents have changed
-    if (!utilities::deref_equals(m_channels, allChannels))
+    if (!utilities::deref_equals(std::atomic_load(&m_channels)->channels, allChannels))
     {
-      std::unique_lock<std::mutex> lock(m_mutex);
-      m_channels = allChannels;
-      kodi::Log(ADDON_LOG_INFO, "Channels database version updated to %u", newDBversion);
-      m_channelsDBVersion = newDBversion;
+      PublishChannels(std::move(allChannels), dbVersion);
 
-      if (triggerEvent)
+      // The handler isn't attached yet during startup
+      if (triggerEvent && OnChannelsUpdated)
         OnChannelsUpdated();
     }
+    else
+      m_channelsDBVersion = dbVersion;
   }
   catch (VBoxException& e)
   {
@@ -893,8 +1206,52 @@ void VBox::RetrieveChannels(bool triggerEvent /* = true*/)
     m_stateHandler.EnterState(StartupState::CHANNELS_LOADED);
 }
 
-void VBox::RetrieveRecordings(bool triggerEvent /* = true*/)
+void VBox::PublishChannels(std::vector<ChannelPtr> channels, unsigned int dbVersion)
+{
+  // Build the new snapshot including its lookup tables. The first channel
+  // wins if there are duplicates
+  auto channelList = std::make_shared<ChannelList>();
+
+  for (const auto& channel : channels)
+  {
+    channelList->byUniqueId.emplace(ContentIdentifier::GetUniqueId(channel), channel);
+    channelList->byXmltvName.emplace(channel->m_xmltvName, channel);
+  }
+
+  channelList->channels = std::move(channels);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::atomic_store(&m_channels, std::shared_ptr<const ChannelList>(channelList));
+  kodi::Log(ADDON_LOG_INFO, "Channels database version updated to %u", dbVersion);
+  m_channelsDBVersion = dbVersion;
+}
+
+bool VBox::LoadCachedChannels()
+{
+  std::vector<ChannelPtr> channels;
+  unsigned int dbVersion = 0;
+
+  if (!m_channelCache->Load(channels, dbVersion))
+  {
+    kodi::Log(ADDON_LOG_INFO, "No usable channel cache found");
+    return false;
+  }
+
+  kodi::Log(ADDON_LOG_INFO, "Loaded %d channels from the cache", static_cast<int>(channels.size()));
+
+  // The background updater revalidates the channels against the backend
+  PublishChannels(std::move(channels), dbVersion);
+
+  if (m_stateHandler.GetState() < StartupState::CHANNELS_LOADED)
+    m_stateHandler.EnterState(StartupState::CHANNELS_LOADED);
+
+  return true;
+}
+
+bool VBox::RetrieveRecordings(bool triggerEvent /* = true*/)
 {
+  bool retrieved = true;
+
   // Only attempt to retrieve recordings when external media is present
   if (m_backendInformation.externalMediaStatus.present)
   {
@@ -906,15 +1263,17 @@ void VBox::RetrieveRecordings(bool triggerEvent /* = true*/)
       response::RecordingResponseContent content(response->GetReplyElement());
 
       // Compare the results
-      auto recordings = content.GetRecordings();
-      auto series = content.GetSeriesRecordings();
+      auto recordingList = std::make_shared<RecordingList>();
+      recordingList->recordings = content.GetRecordings();
+      recordingList->series = content.GetSeriesRecordings();
       std::unique_lock<std::mutex> lock(m_mutex);
+      auto currentList = std::atomic_load(&m_recordings);
 
       // Swap and notify if the contents have changed
-      if (!utilities::deref_equals(m_recordings, recordings) || !utilities::deref_equals(m_series, series))
+      if (!utilities::deref_equals(currentList->recordings, recordingList->recordings) ||
+          !utilities::deref_equals(currentList->series, recordingList->series))
       {
-        m_recordings = std::move(content.GetRecordings());
-        m_series = std::move(content.GetSeriesRecordings());
+        std::atomic_store(&m_recordings, std::shared_ptr<const RecordingList>(recordingList));
         if (triggerEvent)
         {
           OnRecordingsUpdated();
@@ -927,11 +1286,14 @@ void VBox::RetrieveRecordings(bool triggerEvent /* = true*/)
       // Intentionally don't return, the request fails if there are no
       // recordings (which is technically not an error)
       LogException(e);
+      retrieved = false;
     }
   }
 
   if (m_stateHandler.GetState() < StartupState::RECORDINGS_LOADED)
     m_stateHandler.EnterState(StartupState::RECORDINGS_LOADED);
+
+  return retrieved;
 }
 
 void VBox::RetrieveGuide(bool triggerEvent /* = true*/)
@@ -940,63 +1302,139 @@ void VBox::RetrieveGuide(bool triggerEvent /* = true*/)
 
   try
   {
-    std::string progsDBVerName("ProgramsDataBaseVersion");
-    unsigned int newDBversion = GetDBVersion(progsDBVerName);
+    unsigned int newDBversion = GetDBVersions().programs;
 
     // if same as last fetched guide, no need for fetching again (unless syncing EPG)
     if (!m_shouldSyncEpg && newDBversion == m_programsDBVersion)
       return;
 
     // Retrieving the whole XMLTV file is too slow so we fetch sections in
-    // batches of 10 channels and merge the results
+    // batches and merge the results. The batch size adapts to the size and
+    // response time of the sections
     int lastChannelIndex;
 
-    {
-      std::unique_lock<std::mutex> lock(m_mutex);
-      lastChannelIndex = m_channels.size();
-    }
+    auto channelList = std::atomic_load(&m_channels);
+    lastChannelIndex = channelList->channels.size();
+    auto currentGuide = std::atomic_load(&m_guide);
 
     xmltv::Guide guide;
-
-    for (int fromIndex = 1; fromIndex <= lastChannelIndex; fromIndex += CHANNELS_PER_EPGBATCH)
+    std::set<std::string> changedChannelIds;
+    std::mutex guideMutex;
+    std::atomic<int> nextFromIndex(1);
+    std::atomic<bool> complete(true);
+
+    // Each worker claims the next batch, downloads and parses it and merges
+    // the result into the guide, so a batch is parsed while the other workers
+    // are still waiting for their responses
+    auto fetchBatches = [this, &currentGuide, &guide, &changedChannelIds, &guideMutex, &nextFromIndex, &complete,
+                         lastChannelIndex]()
     {
-      // Abort immediately if the addon just got terminated
-      if (!m_active)
-        return;
+      while (m_active)
+      {
+        int batchSize = m_guideBatchSize.GetBatchSize();
+        int fromIndex = nextFromIndex.fetch_add(batchSize);
 
-      int toIndex = std::min(fromIndex + (CHANNELS_PER_EPGBATCH - 1), lastChannelIndex);
+        if (fromIndex > lastChannelIndex)
+          break;
 
-      // Swallow exceptions, we don't want guide loading to fail just because
-      // one request failed
-      try
-      {
-        request::ApiRequest request("GetXmltvSection", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
-        request.AddParameter("FromChIndex", fromIndex);
-        request.AddParameter("ToChIndex", toIndex);
-        response::ResponsePtr response = PerformRequest(request);
-        response::XMLTVResponseContent content(response->GetReplyElement());
+        int toIndex = std::min(fromIndex + (batchSize - 1), lastChannelIndex);
 
-        auto partialGuide = content.GetGuide();
-        guide += partialGuide;
+        // Swallow exceptions, we don't want guide loading to fail just because
+        // one request failed
+        try
+        {
+          request::ApiRequest request("GetXmltvSection", GetConnectionParams().hostname, GetConnectionParams().upnpPort);
+          request.AddParameter("FromChIndex", fromIndex);
+          request.AddParameter("ToChIndex", toIndex);
+
+          size_t responseSize = 0;
+          auto startTime = std::chrono::steady_clock::now();
+          auto partialGuide = PerformGuideRequest(request, responseSize);
+          m_guideBatchSize.AddSample(toIndex - fromIndex + 1, responseSize,
+                                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now() - startTime));
+
+          // Compare the batch with the current guide and keep the existing
+          // schedules where nothing changed
+          auto changedIds = partialGuide.ReuseUnchangedSchedules(*currentGuide);
+
+          std::unique_lock<std::mutex> lock(guideMutex);
+          guide += partialGuide;
+          changedChannelIds.insert(changedIds.cbegin(), changedIds.cend());
+        }
+        catch (VBoxException& e)
+        {
+          LogException(e);
+          complete = false;
+        }
       }
-      catch (VBoxException& e)
+    };
+
+    // Keep a bounded number of section requests in flight so the gateway
+    // isn't overloaded
+    int batchSize = m_guideBatchSize.GetBatchSize();
+    int numBatches = (lastChannelIndex + batchSize - 1) / batchSize;
+    int numWorkers = std::min(std::max(m_settings->m_guideFetchConcurrency, 1), std::max(numBatches, 1));
+    std::vector<std::thread> workers;
+
+    for (int i = 1; i < numWorkers; i++)
+      workers.emplace_back(fetchBatches);
+
+    fetchBatches();
+
+    for (auto& worker : workers)
+      worker.join();
+
+    // Abort immediately if the addon just got terminated
+    if (!m_active)
+      return;
+
+    m_guideBatchSize.LogStatistics(m_backendInformation.name);
+    LogGuideStatistics(guide);
+
+    // Channels that disappeared from the guide have changed too
+    for (const auto& entry : currentGuide->GetSchedules())
+    {
+      if (!guide.GetSchedule(entry.first))
+        changedChannelIds.insert(entry.first);
+    }
+
+    kodi::Log(ADDON_LOG_INFO, "Guide data changed for %d of %d channels", static_cast<int>(changedChannelIds.size()),
+              static_cast<int>(guide.GetSchedules().size()));
+
+    // Swap the guide with the new one. Readers still using the old guide keep
+    // it alive until they're done. Like the channel list, an incomplete guide
+    // is still used but the database version isn't advanced, so that the
+    // guide is fetched again instead of being considered up to date
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      std::atomic_store(&m_guide, std::shared_ptr<const xmltv::Guide>(std::make_shared<xmltv::Guide>(std::move(guide))));
+
+      if (complete)
       {
-        LogException(e);
+        kodi::Log(ADDON_LOG_INFO, "Guide database version updated to %u", newDBversion);
+        m_programsDBVersion = newDBversion;
       }
+      else
+        kodi::Log(ADDON_LOG_WARNING, "Some guide sections could not be retrieved, they will be fetched again later");
     }
 
-    LogGuideStatistics(guide);
+    // Find the channels that need their EPG refreshed. A manual sync refreshes
+    // every channel
+    std::vector<ChannelPtr> changedChannels;
 
-    // Swap the guide with the new one
+    for (const auto& channel : channelList->channels)
     {
-      std::unique_lock<std::mutex> lock(m_mutex);
-      m_guide = guide;
-      kodi::Log(ADDON_LOG_INFO, "Guide database version updated to %u", newDBversion);
-      m_programsDBVersion = newDBversion;
+      if (m_shouldSyncEpg || changedChannelIds.find(channel->m_xmltvName) != changedChannelIds.end())
+        changedChannels.push_back(channel);
     }
 
-    if (triggerEvent)
-      OnGuideUpdated();
+    if (triggerEvent && !changedChannels.empty())
+      OnGuideUpdated(changedChannels);
+
+    // Only a complete guide is remembered for the next startup
+    if (complete)
+      m_guideCache->Save(*std::atomic_load(&m_guide), newDBversion);
   }
   catch (VBoxException& e)
   {
@@ -1008,6 +1446,33 @@ void VBox::RetrieveGuide(bool triggerEvent /* = true*/)
     m_stateHandler.EnterState(StartupState::GUIDE_LOADED);
 }
 
+void VBox::LoadCachedGuide()
+{
+  unsigned int dbVersion = 0;
+  auto startTime = std::chrono::steady_clock::now();
+  std::unique_ptr<xmltv::Guide> guide = m_guideCache->Load(dbVersion);
+
+  if (!guide)
+  {
+    kodi::Log(ADDON_LOG_INFO, "No usable guide cache found");
+    return;
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+  kodi::Log(ADDON_LOG_INFO, "Loaded guide database version %u from the cache in %d ms", dbVersion,
+            static_cast<int>(duration.count()));
+
+  // Publish the cached guide, RetrieveGuide() will skip the download if the
+  // database version hasn't changed since
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::atomic_store(&m_guide, std::shared_ptr<const xmltv::Guide>(std::move(guide)));
+    m_programsDBVersion = dbVersion;
+  }
+
+  m_cachedGuideLoaded = true;
+}
+
 void VBox::InitializeGenreMapper()
 {
   // Abort if we're already initialized or the external guide is not loaded
@@ -1062,21 +1527,146 @@ void VBox::LogGuideStatistics(const xmltv::Guide& guide) const
   }
 }
 
+template<class Result>
+Result VBox::PerformWithRetry(const request::Request& request, const std::function<Result()>& perform) const
+{
+  unsigned int maxAttempts = request.IsIdempotent() ? MAX_REQUEST_ATTEMPTS : 1;
+
+  for (unsigned int attempt = 1;; attempt++)
+  {
+    // Fail fast while the gateway is known to be unresponsive
+    if (!m_circuitBreaker.AllowRequest())
+    {
+      m_consecutiveFailures++;
+      throw RequestFailedException("Gateway is not responding, skipping request (" + request.GetIdentifier() + ")");
+    }
+
+    try
+    {
+      Result result = perform();
+      m_consecutiveFailures = 0;
+      m_circuitBreaker.RecordSuccess();
+
+      return result;
+    }
+    catch (RequestFailedException&)
+    {
+      // Only count failures to reach the backend at all
+      m_consecutiveFailures++;
+      m_circuitBreaker.RecordFailure();
+
+      if (attempt >= maxAttempts)
+        throw;
+    }
+    catch (InvalidXMLException&)
+    {
+      // The gateway answered but the response was cut short
+      m_consecutiveFailures = 0;
+      m_circuitBreaker.RecordSuccess();
+
+      if (attempt >= maxAttempts)
+        throw;
+    }
+    catch (VBoxException&)
+    {
+      m_consecutiveFailures = 0;
+      m_circuitBreaker.RecordSuccess();
+      throw;
+    }
+
+    // Back off exponentially, with full jitter so that concurrent requests
+    // don't retry in lockstep
+    static thread_local std::mt19937 generator(std::random_device{}());
+    auto maxDelay = std::min(RETRY_BASE_DELAY * (1 << (attempt - 1)), RETRY_MAX_DELAY);
+    std::uniform_int_distribution<long long> distribution(0, maxDelay.count());
+    std::chrono::milliseconds delay(distribution(generator));
+
+    kodi::Log(ADDON_LOG_DEBUG, "Request %s failed (attempt %u of %u), retrying in %d ms",
+              request.GetIdentifier().c_str(), attempt, maxAttempts, static_cast<int>(delay.count()));
+    std::this_thread::sleep_for(delay);
+  }
+}
+
 response::ResponsePtr VBox::PerformRequest(const request::Request& request) const
 {
-  // Attempt to open a HTTP file handle
-  kodi::vfs::CFile fileHandle;
+  auto perform = [this, &request]()
+  {
+    return PerformWithRetry<response::ResponsePtr>(request, [this, &request]()
+    {
+      return PerformRequest(request, GetConnectionParams(), *m_connectionPool, *m_requestMetrics);
+    });
+  };
+
+  std::string location = request.GetLocation("");
+
+  if (request.IsIdempotent())
+  {
+    unsigned int epoch = m_responseCache.GetEpoch();
+    response::ResponsePtr response = m_responseCache.Get(request.GetIdentifier(), location);
+
+    // Identical read-only requests that are made at the same time share a
+    // single call and its response, unless a mutating request has completed
+    // since that call started
+    if (!response)
+    {
+      std::string key = std::to_string(m_mutationGeneration.load()) + " " + location;
+      response = m_singleFlight.Perform(key, perform);
+      m_responseCache.Put(request.GetIdentifier(), location, response, epoch);
+    }
+
+    return response;
+  }
+
+  // Anything cached or in flight may be outdated after a mutating request,
+  // even a failed one
+  try
+  {
+    response::ResponsePtr response = perform();
+    m_mutationGeneration++;
+    m_responseCache.Clear();
+
+    return response;
+  }
+  catch (VBoxException&)
+  {
+    m_mutationGeneration++;
+    m_responseCache.Clear();
+    throw;
+  }
+}
+
+response::ResponsePtr VBox::PerformRequest(const request::Request& request, const ConnectionParameters& params,
+                                           HttpConnectionPool& pool, RequestMetrics& metrics)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  auto transferEndTime = startTime;
+  bool transferred = false;
+  size_t bytesReceived = 0;
 
-  if (fileHandle.OpenFile(request.GetLocation(GetApiBaseUrl()), ADDON_READ_NO_CACHE))
+  try
   {
-    // Read the response string
-    std::unique_ptr<std::string> responseContent = utilities::ReadFileContents(fileHandle);
-    fileHandle.Close();
+    // Attempt to open a HTTP connection
+    HttpConnectionPtr connection = pool.Acquire(params.GetUriAuthority());
+
+    // The request failed completely
+    if (!connection->Open(request.GetLocation(GetApiBaseUrl(params))))
+      throw RequestFailedException("Unable to perform request (" + request.GetIdentifier() + ")");
+
+    // Read the response string and hand the connection back
+    std::unique_ptr<std::string> responseContent = utilities::ReadFileContents(connection->GetFile());
+    connection.reset();
+
+    bytesReceived = responseContent->size();
+    transferEndTime = std::chrono::steady_clock::now();
+    transferred = true;
 
     // Parse the response
     response::ResponsePtr response = response::Factory::CreateResponse(request);
     response->ParseRawResponse(*responseContent.get());
 
+    // The document keeps its own copy, free the raw response right away
+    responseContent.reset();
+
     // Check if the response was successful
     if (!response->IsSuccessful())
     {
@@ -1087,11 +1677,110 @@ response::ResponsePtr VBox::PerformRequest(const request::Request& request) cons
       throw InvalidResponseException(ss.str());
     }
 
+    metrics.Record(request.GetIdentifier(), true, bytesReceived, transferEndTime - startTime,
+                   std::chrono::steady_clock::now() - transferEndTime);
+
     return response;
   }
+  catch (VBoxException&)
+  {
+    auto endTime = std::chrono::steady_clock::now();
+
+    if (!transferred)
+      transferEndTime = endTime;
+
+    metrics.Record(request.GetIdentifier(), false, bytesReceived, transferEndTime - startTime,
+                   endTime - transferEndTime);
+    throw;
+  }
+}
+
+::xmltv::Guide VBox::PerformGuideRequest(const request::Request& request, size_t& responseSize) const
+{
+  return PerformWithRetry<::xmltv::Guide>(request, [this, &request, &responseSize]()
+  {
+    return ReadGuideResponse(request, responseSize);
+  });
+}
+
+::xmltv::Guide VBox::ReadGuideResponse(const request::Request& request, size_t& responseSize) const
+{
+  auto startTime = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration parseTime(0);
+  ConnectionParameters params = GetConnectionParams();
+  HttpConnectionPtr connection = m_connectionPool->Acquire(params.GetUriAuthority());
+
+  if (!connection->Open(request.GetLocation(GetApiBaseUrl(params))))
+  {
+    m_requestMetrics->Record(request.GetIdentifier(), false, 0, std::chrono::steady_clock::now() - startTime,
+                             parseTime);
+    throw RequestFailedException("Unable to perform request (" + request.GetIdentifier() + ")");
+  }
+
+  // Parse the response as it arrives instead of buffering the whole document
+  ::xmltv::Guide guide;
+  ::xmltv::GuideReader reader(guide);
+  std::string errorDescription;
+  int errorCode = static_cast<int>(response::ErrorCode::SUCCESS);
+
+  // Errors are reported in an <Error> element inside the XMLTV document
+  reader.OnOtherElement = [&errorDescription, &errorCode](const tinyxml2::XMLElement* element) {
+    if (std::string(element->Name()) != "Error")
+      return;
 
-  // The request failed completely
-  throw RequestFailedException("Unable to perform request (" + request.GetIdentifier() + ")");
+    const tinyxml2::XMLElement* errCodeEl = element->FirstChildElement("ErrorCode");
+    const tinyxml2::XMLElement* errDescEl = element->FirstChildElement("ErrorDescription");
+
+    if (errCodeEl)
+      errorCode = ::xmltv::Utilities::QueryIntText(errCodeEl);
+    if (errDescEl)
+      errorDescription = ::xmltv::Utilities::GetStdString(errDescEl->GetText());
+  };
+
+  std::unique_ptr<char[]> buffer(new char[GUIDE_READ_CHUNK_SIZE]);
+  ssize_t bytesRead = 0;
+  bool valid = true;
+  responseSize = 0;
+
+  while (valid && (bytesRead = connection->GetFile().Read(buffer.get(), GUIDE_READ_CHUNK_SIZE)) > 0)
+  {
+    auto parseStartTime = std::chrono::steady_clock::now();
+
+    responseSize += bytesRead;
+    valid = reader.Feed(buffer.get(), bytesRead);
+    parseTime += std::chrono::steady_clock::now() - parseStartTime;
+  }
+
+  // A failed read means the document is incomplete
+  if (bytesRead < 0)
+    valid = false;
+
+  connection.reset();
+
+  // Parsing is interleaved with the transfer, count everything else as
+  // transfer time
+  auto parseStartTime = std::chrono::steady_clock::now();
+  valid = valid && reader.Finish();
+  auto endTime = std::chrono::steady_clock::now();
+  parseTime += endTime - parseStartTime;
+
+  bool successful = valid && errorCode == static_cast<int>(response::ErrorCode::SUCCESS);
+  m_requestMetrics->Record(request.GetIdentifier(), successful, responseSize, endTime - startTime - parseTime,
+                           parseTime);
+
+  if (!valid)
+    throw InvalidXMLException(bytesRead < 0 ? "Failed to read the response" : reader.GetError());
+
+  if (errorCode != static_cast<int>(response::ErrorCode::SUCCESS))
+  {
+    std::stringstream ss;
+    ss << errorDescription;
+    ss << " (error code: " << errorCode << ")";
+
+    throw InvalidResponseException(ss.str());
+  }
+
+  return guide;
 }
 
 void VBox::LogException(VBoxException& e)
@@ -1099,3 +1788,12 @@ void VBox::LogException(VBoxException& e)
   std::string message = "Request failed: " + std::string(e.what());
   kodi::Log(ADDON_LOG_ERROR, message.c_str());
 }
+
+void VBox::LogRequestStatistics(ADDON_LOG level) const
+{
+  m_requestMetrics->LogStatistics(level);
+  m_connectionPool->LogStatistics();
+  m_responseCache.LogStatistics(level);
+  kodi::Log(level, "%u requests were shared with an identical request in flight",
+            m_singleFlight.GetSharedCalls());
+}
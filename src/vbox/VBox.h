@@ -11,14 +11,23 @@
 #include "../xmltv/Guide.h"
 #include "../xmltv/Programme.h"
 #include "../xmltv/Schedule.h"
+#include "BatchSizeController.h"
 #include "CategoryGenreMapper.h"
+#include "CacheFile.h"
+#include "ChannelCache.h"
 #include "Channel.h"
 #include "ChannelStreamingStatus.h"
+#include "CircuitBreaker.h"
 #include "Exceptions.h"
+#include "GuideCache.h"
 #include "GuideChannelMapper.h"
+#include "HttpConnectionPool.h"
 #include "Recording.h"
+#include "RequestMetrics.h"
+#include "ResponseCache.h"
 #include "SeriesRecording.h"
 #include "InstanceSettings.h"
+#include "SingleFlight.h"
 #include "SoftwareVersion.h"
 #include "StartupStateHandler.h"
 #include "request/ApiRequest.h"
@@ -26,12 +35,15 @@
 #include "response/Response.h"
 
 #include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <kodi/addon-instance/PVR.h>
@@ -95,6 +107,18 @@ namespace vbox
     EPGSCAN_FINISHED
   };
 
+  /**
+   * The versions of the backend's databases. Each one changes whenever the
+   * corresponding data changes
+   */
+  struct DatabaseVersions
+  {
+    unsigned int channels = 0;
+    unsigned int programs = 0;
+    unsigned int records = 0;
+    bool hasRecords = false;
+  };
+
   struct TimedStreamingStatus
   {
     ChannelStreamingStatus m_streamStatus;
@@ -114,6 +138,43 @@ namespace vbox
     }
   };
 
+  /**
+   * The shared state of the connection probes started by
+   * VBox::DetermineConnectionParams()
+   */
+  struct ConnectionRace
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    int winner = -1;
+    size_t failed = 0;
+    response::ResponsePtr response;
+    std::exception_ptr error;
+  };
+
+  /**
+   * An immutable snapshot of the channel list and its lookup tables
+   */
+  struct ChannelList
+  {
+    std::vector<ChannelPtr> channels;
+    std::unordered_map<unsigned int, ChannelPtr> byUniqueId;
+    std::unordered_map<std::string, ChannelPtr> byXmltvName;
+  };
+
+  /**
+   * An immutable snapshot of the recordings, timers and series timers
+   */
+  struct RecordingList
+  {
+    std::vector<RecordingPtr> recordings;
+    std::vector<SeriesRecordingPtr> series;
+  };
+
+  typedef std::shared_ptr<const std::vector<ChannelPtr>> ChannelsPtr;
+  typedef std::shared_ptr<const std::vector<RecordingPtr>> RecordingsPtr;
+  typedef std::shared_ptr<const std::vector<SeriesRecordingPtr>> SeriesRecordingsPtr;
+
   /**
    * The main class for interfacing with the VBox Gateway
    */
@@ -132,10 +193,16 @@ namespace vbox
      * Initializes the addon
      */
     void Initialize();
-    void DetermineConnectionParams();
+
+    /**
+     * Determines whether the internal or external connection parameters
+     * should be used
+     * @return the software version response received while probing
+     */
+    response::ResponsePtr DetermineConnectionParams();
     bool ValidateSettings() const;
     InstanceSettings& GetSettings() const;
-    const ConnectionParameters& GetConnectionParams() const;
+    ConnectionParameters GetConnectionParams() const;
     StartupStateHandler& GetStateHandler();
     std::string GetApiBaseUrl() const;
 
@@ -156,8 +223,9 @@ namespace vbox
 
     // Channel methods
     int GetChannelsAmount() const;
-    const std::vector<ChannelPtr>& GetChannels() const;
+    ChannelsPtr GetChannels() const;
     const ChannelPtr GetChannel(unsigned int uniqueId) const;
+    const ChannelPtr GetChannelByXmltvName(const std::string& xmltvName) const;
     const ChannelPtr GetCurrentChannel() const;
     void SetCurrentChannel(const ChannelPtr& channel);
     ChannelStreamingStatus GetChannelStreamingStatus(const ChannelPtr& channel);
@@ -182,8 +250,8 @@ namespace vbox
                   const std::string title, const std::string description, const unsigned int weekdays);
     // for TIMER_VBOX_TYPE_EPG_BASED_AUTO_SERIES timer
     void AddSeriesTimer(const ChannelPtr& channel, const ::xmltv::ProgrammePtr programme);
-    const std::vector<RecordingPtr>& GetRecordingsAndTimers() const;
-    const std::vector<SeriesRecordingPtr>& GetSeriesTimers() const;
+    RecordingsPtr GetRecordingsAndTimers() const;
+    SeriesRecordingsPtr GetSeriesTimers() const;
     void UpdateRecordingMargins(RecordingMargins defaultMargins);
 
     // EPG methods
@@ -195,12 +263,13 @@ namespace vbox
 
     // Helpers
     static void LogException(VBoxException& e);
+    void LogRequestStatistics(ADDON_LOG level) const;
 
     // Event handlers
     std::function<void()> OnChannelsUpdated;
     std::function<void()> OnRecordingsUpdated;
     std::function<void()> OnTimersUpdated;
-    std::function<void()> OnGuideUpdated;
+    std::function<void(const std::vector<ChannelPtr>& channels)> OnGuideUpdated;
 
   protected:
     /**
@@ -213,10 +282,17 @@ namespace vbox
     static const int INITIAL_EPG_STEP_SECS = 5;
 
     void BackgroundUpdater();
-    unsigned int GetDBVersion(std::string& versionName) const;
+    void JoinConnectionProbes();
+    std::string LoadPreferredConnection() const;
+    void SavePreferredConnection(const std::string& authority) const;
+    void ReevaluateConnectionParams();
+    DatabaseVersions GetDBVersions() const;
     void RetrieveChannels(bool triggerEvent = true);
-    void RetrieveRecordings(bool triggerEvent = true);
+    void PublishChannels(std::vector<ChannelPtr> channels, unsigned int dbVersion);
+    bool LoadCachedChannels();
+    bool RetrieveRecordings(bool triggerEvent = true);
     void RetrieveGuide(bool triggerEvent = true);
+    void LoadCachedGuide();
     void InitializeGenreMapper();
     void SwapChannelIcons(std::vector<ChannelPtr>& channels);
     void SendScanEPG(std::string& rEpgDetectionCheckMethod) const;
@@ -228,11 +304,59 @@ namespace vbox
 
     void LogGuideStatistics(const ::xmltv::Guide& guide) const;
     response::ResponsePtr PerformRequest(const request::Request& request) const;
+    static response::ResponsePtr PerformRequest(const request::Request& request, const ConnectionParameters& params,
+                                                HttpConnectionPool& pool, RequestMetrics& metrics);
+    static std::string GetApiBaseUrl(const ConnectionParameters& params);
+
+    /**
+     * Performs a request that returns an XMLTV document and parses the
+     * response while it is being read
+     * @param request the request
+     * @param responseSize set to the size of the response in bytes
+     * @return the guide
+     */
+    ::xmltv::Guide PerformGuideRequest(const request::Request& request, size_t& responseSize) const;
+    ::xmltv::Guide ReadGuideResponse(const request::Request& request, size_t& responseSize) const;
+
+    /**
+     * Performs a request through the circuit breaker, retrying idempotent
+     * requests with a jittered exponential backoff when they fail
+     * @param request the request
+     * @param perform makes a single attempt at the request
+     * @return the result of the successful attempt
+     */
+    template<class Result>
+    Result PerformWithRetry(const request::Request& request, const std::function<Result()>& perform) const;
 
     /**
-     * The connection parameters to use for requests
+     * The connection parameters to use for requests. They may change at
+     * runtime, so they're protected by m_connectionMutex
      */
     ConnectionParameters m_currentConnectionParameters;
+    mutable std::mutex m_connectionMutex;
+
+    /**
+     * The number of requests in a row that failed to reach the backend. The
+     * connection parameters are re-evaluated when it grows too large
+     */
+    mutable std::atomic<unsigned int> m_consecutiveFailures{0};
+
+    /**
+     * The probes started by the last DetermineConnectionParams() call. The
+     * losing probe may still be running after the race has been decided
+     */
+    std::vector<std::thread> m_connectionProbes;
+
+    /**
+     * The pool of HTTP connections used for API requests. Shared with the
+     * connection probes, which may outlive a DetermineConnectionParams() call
+     */
+    std::shared_ptr<HttpConnectionPool> m_connectionPool;
+
+    /**
+     * Remembers which endpoint answered first, across restarts
+     */
+    std::unique_ptr<CacheFile> m_connectionCache;
 
     /**
      * The backend information
@@ -240,25 +364,60 @@ namespace vbox
     BackendInformation m_backendInformation;
 
     /**
-     * The list of channels
+     * The list of channels. Snapshots are never modified once published,
+     * readers load the pointer with std::atomic_load() and writers replace it
+     * with std::atomic_store()
      */
-    std::vector<ChannelPtr> m_channels;
+    std::shared_ptr<const ChannelList> m_channels;
 
     /**
-     * The list of recordings, including timeres
+     * The list of recordings, including timers and series timers. Published
+     * the same way as m_channels
      */
-    std::vector<RecordingPtr> m_recordings;
+    std::shared_ptr<const RecordingList> m_recordings;
 
     /**
-    * The list of recordings, including timeres
-    */
-    std::vector<SeriesRecordingPtr> m_series;
+     * The guide data. The XMLTV channel name is the key, the value is the
+     * schedule for the channel. Published the same way as m_channels
+     */
+    std::shared_ptr<const ::xmltv::Guide> m_guide;
 
     /**
-     * The guide data. The XMLTV channel name is the key, the value is the
-     * schedule for the channel
+     * Statistics about the requests made to the gateway. Shared with the
+     * connection probes
+     */
+    std::shared_ptr<RequestMetrics> m_requestMetrics;
+
+    /**
+     * Stops requests from being made while the gateway is unresponsive
+     */
+    mutable CircuitBreaker m_circuitBreaker;
+
+    /**
+     * Coalesces identical requests that are made concurrently
+     */
+    mutable SingleFlight m_singleFlight;
+
+    /**
+     * Bumped after every mutating request, so that read-only requests made
+     * afterwards never join a call that started before the mutation
      */
-    ::xmltv::Guide m_guide;
+    mutable std::atomic<unsigned int> m_mutationGeneration;
+
+    /**
+     * Caches the responses of cheap read-only requests
+     */
+    mutable ResponseCache m_responseCache;
+
+    /**
+     * The on-disk cache of the channel list
+     */
+    std::unique_ptr<ChannelCache> m_channelCache;
+
+    /**
+     * The on-disk cache of the guide data
+     */
+    std::unique_ptr<GuideCache> m_guideCache;
 
     /**
      * The external guide data
@@ -275,6 +434,13 @@ namespace vbox
      */
     CategoryMapperPtr m_categoryGenreMapper;
 
+    /**
+     * Decide how many channels are requested per channel list and guide
+     * section request
+     */
+    BatchSizeController m_channelBatchSize;
+    BatchSizeController m_guideBatchSize;
+
     /**
      * Handler for the startup state
      */
@@ -305,6 +471,17 @@ namespace vbox
     */
     std::atomic<unsigned int> m_programsDBVersion;
 
+    /**
+    * Whether a guide has been loaded from the cache. It can be used before the
+    * GUIDE_LOADED startup state, which has to wait for the recordings
+    */
+    std::atomic<bool> m_cachedGuideLoaded{false};
+
+    /**
+    * Contains the recordings' database version, as it was last updated (0 before update)
+    */
+    std::atomic<unsigned int> m_recordsDBVersion{0};
+
     /**
      * Controls whether the background update thread should keep running or not
      */
@@ -322,7 +499,8 @@ namespace vbox
     ChannelPtr m_currentChannel;
 
     /**
-     * Mutex for protecting access to m_channels and m_recordings
+     * Serializes the writers of m_channels, m_recordings and m_guide. Readers
+     * don't need it
      */
     mutable std::mutex m_mutex;
   };
@@ -82,6 +82,12 @@ std::string ApiRequest::GetIdentifier() const
   return m_method;
 }
 
+bool ApiRequest::IsIdempotent() const
+{
+  // Query* and Get* methods only read data
+  return m_method.compare(0, 5, "Query") == 0 || m_method.compare(0, 3, "Get") == 0;
+}
+
 void ApiRequest::AddParameter(const std::string& name, const std::string& value)
 {
   m_parameters[name].push_back(value);
@@ -43,6 +43,7 @@ namespace vbox
       virtual vbox::response::ResponseType GetResponseType() const override;
       virtual std::string GetLocation(std::string url) const override;
       virtual std::string GetIdentifier() const override;
+      virtual bool IsIdempotent() const override;
 
     private:
       /**
@@ -36,6 +36,8 @@ namespace vbox
 
       virtual std::string GetIdentifier() const override { return "FileRequest for \"" + m_path + "\""; }
 
+      virtual bool IsIdempotent() const override { return true; }
+
     private:
       std::string m_path;
     };
@@ -39,6 +39,11 @@ namespace vbox
        * @return an identifier for this request (mainly for logging purposes)
        */
       virtual std::string GetIdentifier() const = 0;
+
+      /**
+       * @return whether the request can safely be repeated if it fails
+       */
+      virtual bool IsIdempotent() const = 0;
     };
   } // namespace request
 } // namespace vbox
@@ -186,9 +186,12 @@ RecordingPtr RecordingResponseContent::CreateRecording(const tinyxml2::XMLElemen
   else
     recording->m_endTime = xmltv::Utilities::UnixTimeToXmltv(time(nullptr) + 86400);
 
+  recording->m_startTimestamp = xmltv::Utilities::XmltvToUnixTime(recording->m_startTime);
+  recording->m_endTimestamp = xmltv::Utilities::XmltvToUnixTime(recording->m_endTime);
+
   std::time_t now = std::time(nullptr);
-  std::time_t startTime = xmltv::Utilities::XmltvToUnixTime(recording->m_startTime);
-  std::time_t endTime = xmltv::Utilities::XmltvToUnixTime(recording->m_endTime);
+  std::time_t startTime = recording->m_startTimestamp;
+  std::time_t endTime = recording->m_endTimestamp;
   if (startTime > now && now < endTime)
     recording->m_duration = static_cast<int>(now - startTime);
   else
@@ -287,6 +290,9 @@ SeriesRecordingPtr RecordingResponseContent::CreateSeriesRecording(const tinyxml
       AddWeekdayBits(series->m_weekdays, xmltv::Utilities::GetStdString(element->GetText()).c_str());
   }
 
+  series->m_startTimestamp = xmltv::Utilities::XmltvToUnixTime(series->m_startTime);
+  series->m_endTimestamp = xmltv::Utilities::XmltvToUnixTime(series->m_endTime);
+
   return series;
 }
 
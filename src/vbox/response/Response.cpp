@@ -30,6 +30,8 @@ Response::~Response()
 
 void Response::ParseRawResponse(const std::string& rawResponse)
 {
+  m_rawResponseSize = rawResponse.size();
+
   // Try to parse the response as XML
   if (m_document->Parse(rawResponse.c_str(), rawResponse.size()) != XML_SUCCESS)
     throw vbox::InvalidXMLException("XML parsing failed: " + std::string(m_document->ErrorName()));
@@ -19,7 +19,7 @@ namespace vbox
   {
 
     class Response;
-    typedef std::unique_ptr<Response> ResponsePtr;
+    typedef std::shared_ptr<Response> ResponsePtr;
 
     /**
      * The various response types (indicates what kind of content the response
@@ -83,6 +83,11 @@ namespace vbox
        */
       void ParseRawResponse(const std::string& rawResponse);
 
+      /**
+       * @return the size of the raw response in bytes
+       */
+      size_t GetRawResponseSize() const { return m_rawResponseSize; }
+
       /**
        * @return whether the response was successful
        */
@@ -129,6 +134,11 @@ namespace vbox
        * The response error
        */
       Error m_error;
+
+      /**
+       * The size of the raw response
+       */
+      size_t m_rawResponseSize = 0;
     };
 
     /**
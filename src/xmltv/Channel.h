@@ -26,6 +26,13 @@ namespace xmltv
     Channel(const std::string& id, const std::string& displayName);
     ~Channel() = default;
 
+    bool operator==(const Channel& other) const
+    {
+      return m_id == other.m_id && m_displayName == other.m_displayName && m_icon == other.m_icon;
+    }
+
+    bool operator!=(const Channel& other) const { return !(*this == other); }
+
     std::string m_id;
     std::string m_displayName;
     std::string m_icon;
@@ -25,40 +25,68 @@ Guide::Guide(const XMLElement* m_content)
 {
   for (const XMLElement* element = m_content->FirstChildElement("channel"); element != NULL;
        element = element->NextSiblingElement("channel"))
-  {
-    // Create the channel
-    std::string channelId = Utilities::UrlDecode(element->Attribute("id"));
-    const char* pChannelName = element->FirstChildElement("display-name")->GetText();
-    std::string displayName = pChannelName ? pChannelName : "";
-    ChannelPtr channel = ChannelPtr(new Channel(channelId, displayName));
-
-    // Add channel icon if it exists
-    auto* iconElement = element->FirstChildElement("icon");
-    if (iconElement)
-      channel->m_icon = iconElement->Attribute("src");
-
-    // Populate the lookup table which maps XMLTV IDs to display names
-    AddDisplayNameMapping(displayName, channelId);
-
-    // Create a schedule for the channel
-    m_schedules[channelId] = SchedulePtr(new Schedule(channel));
-  }
+    AddChannel(element);
 
   for (const XMLElement* element = m_content->FirstChildElement("programme"); element != NULL;
        element = element->NextSiblingElement("programme"))
-  {
-    // Extract the channel name and the programme
-    std::string channelId = Utilities::UrlDecode(element->Attribute("channel"));
-    xmltv::ProgrammePtr programme(new Programme(element));
+    AddProgramme(element);
+}
+
+void Guide::AddChannel(const XMLElement* element)
+{
+  // Create the channel
+  std::string channelId = Utilities::UrlDecode(element->Attribute("id"));
+  const char* pChannelName = element->FirstChildElement("display-name")->GetText();
+  std::string displayName = pChannelName ? pChannelName : "";
+  ChannelPtr channel = ChannelPtr(new Channel(channelId, displayName));
+
+  // Add channel icon if it exists
+  auto* iconElement = element->FirstChildElement("icon");
+  if (iconElement)
+    channel->m_icon = iconElement->Attribute("src");
+
+  // Populate the lookup table which maps XMLTV IDs to display names
+  AddDisplayNameMapping(displayName, channelId);
+
+  // Create a schedule for the channel
+  m_schedules[channelId] = SchedulePtr(new Schedule(channel));
+}
+
+void Guide::AddProgramme(const XMLElement* element)
+{
+  // Extract the channel name and the programme
+  std::string channelId = Utilities::UrlDecode(element->Attribute("channel"));
+  xmltv::ProgrammePtr programme(new Programme(element));
 
-    // Drop program if missing start/end times or channel
-    if (programme->m_channelName.empty() || programme->m_startTime.empty() || programme->m_endTime.empty())
-      continue;
+  // Drop program if missing start/end times or channel
+  if (programme->m_channelName.empty() || programme->m_startTime.empty() || programme->m_endTime.empty())
+    return;
 
-    // Add the programme to the channel's schedule only if the title was parsable
-    if (programme->m_title != Programme::STRING_FORMAT_NOT_SUPPORTED)
-      m_schedules[channelId]->AddProgramme(programme);
+  // Drop programmes for channels that haven't been declared
+  auto it = m_schedules.find(channelId);
+  if (it == m_schedules.end())
+    return;
+
+  // Add the programme to the channel's schedule only if the title was parsable
+  if (programme->m_title != Programme::STRING_FORMAT_NOT_SUPPORTED)
+    it->second->AddProgramme(programme);
+}
+
+std::vector<std::string> Guide::ReuseUnchangedSchedules(const Guide& previous)
+{
+  std::vector<std::string> changedChannelIds;
+
+  for (auto& entry : m_schedules)
+  {
+    const SchedulePtr previousSchedule = previous.GetSchedule(entry.first);
+
+    if (previousSchedule && *previousSchedule == *entry.second)
+      entry.second = previousSchedule;
+    else
+      changedChannelIds.push_back(entry.first);
   }
+
+  return changedChannelIds;
 }
 
 std::string Guide::GetChannelId(const std::string& displayName) const
@@ -56,6 +56,18 @@ namespace xmltv
       return *this;
     }
 
+    /**
+     * Adds the channel described by the specified <channel> element and
+     * creates an empty schedule for it
+     */
+    void AddChannel(const tinyxml2::XMLElement* element);
+
+    /**
+     * Adds the programme described by the specified <programme> element to
+     * its channel's schedule
+     */
+    void AddProgramme(const tinyxml2::XMLElement* element);
+
     /**
      * Adds the specified schedule on the specified channel
      * @param channelId the channel name
@@ -70,6 +82,15 @@ namespace xmltv
       */
     const SchedulePtr GetSchedule(const std::string& channelId) const;
 
+    /**
+     * Replaces every schedule that is identical to the corresponding schedule
+     * in the previous guide with the previous one, so that unchanged
+     * schedules are shared between the guides
+     * @param previous the previous guide
+     * @return the IDs of the channels whose schedules are new or changed
+     */
+    std::vector<std::string> ReuseUnchangedSchedules(const Guide& previous);
+
     /**
       * Adds a new mapping between the display name and the channel ID
       * @param displayName the display name
@@ -100,6 +121,11 @@ namespace xmltv
       return channelNames;
     }
 
+    /**
+     * @return the mappings from display names to XMLTV channel IDs
+     */
+    const std::map<std::string, std::string>& GetDisplayNameMappings() const { return m_displayNameMappings; }
+
     /**
       * @return the schedules
       */
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "GuideReader.h"
+
+#include <cstring>
+
+#include <tinyxml2.h>
+
+using namespace xmltv;
+using namespace tinyxml2;
+
+GuideReader::GuideReader(Guide& guide) : m_guide(guide)
+{
+  // Same settings as used for complete responses
+  m_document =
+      std::unique_ptr<XMLDocument>(new XMLDocument(/*processEntities = */ true, tinyxml2::PRESERVE_WHITESPACE));
+}
+
+GuideReader::~GuideReader()
+{
+}
+
+bool GuideReader::Feed(const char* data, size_t length)
+{
+  if (!m_error.empty())
+    return false;
+
+  m_buffer.append(data, length);
+  return Process();
+}
+
+bool GuideReader::Finish()
+{
+  if (!m_error.empty())
+    return false;
+
+  if (!m_rootOpened)
+  {
+    m_error = "XML parsing failed: no root element";
+    return false;
+  }
+
+  if (!m_rootClosed || m_depth != 0 || m_buffer.find('<', m_position) != std::string::npos)
+  {
+    m_error = "XML parsing failed: unexpected end of document";
+    return false;
+  }
+
+  return true;
+}
+
+bool GuideReader::Process()
+{
+  while (true)
+  {
+    size_t start = m_buffer.find('<', m_position);
+
+    if (start == std::string::npos)
+    {
+      m_position = m_buffer.size();
+      break;
+    }
+
+    // Wait for more data if the markup isn't complete yet
+    size_t end = FindMarkupEnd(start);
+
+    if (end == std::string::npos)
+    {
+      m_position = start;
+      break;
+    }
+
+    char type = m_buffer[start + 1];
+
+    if (type == '/')
+    {
+      if (m_depth == 0)
+      {
+        m_error = "XML parsing failed: mismatched element";
+        return false;
+      }
+
+      // A top-level element was just closed
+      if (--m_depth == 1 && !HandleElement(m_elementStart, end + 1))
+        return false;
+
+      if (m_depth == 0)
+        m_rootClosed = true;
+    }
+    else if (type != '!' && type != '?')
+    {
+      bool selfClosing = m_buffer[end - 1] == '/';
+
+      if (m_depth == 0)
+      {
+        m_rootOpened = true;
+        m_rootClosed = selfClosing;
+      }
+      else if (m_depth == 1)
+        m_elementStart = start;
+
+      if (!selfClosing)
+        m_depth++;
+      else if (m_depth == 1 && !HandleElement(start, end + 1))
+        return false;
+    }
+
+    m_position = end + 1;
+  }
+
+  // Drop everything that has been consumed, except the element that is
+  // currently being read
+  size_t consumed = m_depth > 1 ? m_elementStart : m_position;
+
+  m_buffer.erase(0, consumed);
+  m_position -= consumed;
+  m_elementStart = m_depth > 1 ? 0 : m_elementStart;
+
+  return true;
+}
+
+size_t GuideReader::FindMarkupEnd(size_t start) const
+{
+  size_t available = m_buffer.size() - start;
+
+  if (available < 2)
+    return std::string::npos;
+
+  if (m_buffer.compare(start, 4, "<!--") == 0)
+  {
+    size_t end = m_buffer.find("-->", start + 4);
+    return end != std::string::npos ? end + 2 : end;
+  }
+
+  if (m_buffer[start + 1] == '?')
+  {
+    size_t end = m_buffer.find("?>", start + 2);
+    return end != std::string::npos ? end + 1 : end;
+  }
+
+  if (m_buffer[start + 1] == '!')
+  {
+    // Need enough data to tell CDATA sections from declarations
+    if (available < 9)
+      return std::string::npos;
+
+    if (m_buffer.compare(start, 9, "<![CDATA[") == 0)
+    {
+      size_t end = m_buffer.find("]]>", start + 9);
+      return end != std::string::npos ? end + 2 : end;
+    }
+  }
+
+  // Regular tags and declarations, skip over quoted values and (for
+  // DOCTYPE) the internal subset
+  char quote = 0;
+  int brackets = 0;
+
+  for (size_t i = start + 1; i < m_buffer.size(); i++)
+  {
+    char c = m_buffer[i];
+
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '[')
+      brackets++;
+    else if (c == ']')
+      brackets--;
+    else if (c == '>' && brackets <= 0)
+      return i;
+  }
+
+  return std::string::npos;
+}
+
+bool GuideReader::HandleElement(size_t start, size_t end)
+{
+  if (m_document->Parse(m_buffer.data() + start, end - start) != XML_SUCCESS)
+  {
+    m_error = "XML parsing failed: " + std::string(m_document->ErrorName());
+    return false;
+  }
+
+  const XMLElement* element = m_document->RootElement();
+
+  if (std::strcmp(element->Name(), "programme") == 0)
+    m_guide.AddProgramme(element);
+  else if (std::strcmp(element->Name(), "channel") == 0)
+    m_guide.AddChannel(element);
+  else if (OnOtherElement)
+    OnOtherElement(element);
+
+  return true;
+}
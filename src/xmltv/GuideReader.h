@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#pragma once
+
+#include "Guide.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+// Forward declarations
+namespace tinyxml2
+{
+  class XMLDocument;
+  class XMLElement;
+}
+
+namespace xmltv
+{
+
+  /**
+   * Reads an XMLTV document incrementally and adds its channels and
+   * programmes to a guide as soon as each of them has been received. Only
+   * the element currently being read is kept in memory, the document as a
+   * whole is never built.
+   */
+  class GuideReader
+  {
+  public:
+    /**
+     * @param guide the guide to add the channels and programmes to
+     */
+    explicit GuideReader(Guide& guide);
+    ~GuideReader();
+
+    /**
+     * Passes the next chunk of the document to the reader
+     * @param data the chunk
+     * @param length the length of the chunk
+     * @return false if the document is malformed
+     */
+    bool Feed(const char* data, size_t length);
+
+    /**
+     * Signals that the whole document has been passed to the reader
+     * @return false if the document is malformed or incomplete
+     */
+    bool Finish();
+
+    /**
+     * @return a description of why reading failed
+     */
+    const std::string& GetError() const { return m_error; }
+
+    /**
+     * Called for every top-level element that is not a channel or programme
+     */
+    std::function<void(const tinyxml2::XMLElement*)> OnOtherElement;
+
+  private:
+    /**
+     * Consumes all complete markup in the buffer
+     * @return false if the document is malformed
+     */
+    bool Process();
+
+    /**
+     * Parses the complete top-level element at the specified range of the
+     * buffer and adds it to the guide
+     * @return false if the element is malformed
+     */
+    bool HandleElement(size_t start, size_t end);
+
+    /**
+     * Finds the end of the markup starting at the specified position
+     * @param start the position of the opening '<'
+     * @return the position of the closing '>', or std::string::npos if the
+     * markup isn't complete yet
+     */
+    size_t FindMarkupEnd(size_t start) const;
+
+    Guide& m_guide;
+
+    /**
+     * Unconsumed data. Holds at most the element currently being read and
+     * the remainder of the last chunk
+     */
+    std::string m_buffer;
+
+    /**
+     * The position in m_buffer to continue reading from
+     */
+    size_t m_position = 0;
+
+    /**
+     * The position in m_buffer of the top-level element currently being read
+     */
+    size_t m_elementStart = 0;
+
+    /**
+     * The current element depth, 1 means inside the root element
+     */
+    int m_depth = 0;
+
+    /**
+     * Whether the root element has been opened and closed. A document
+     * without a complete root element is not a valid guide, even an empty
+     * one
+     */
+    bool m_rootOpened = false;
+    bool m_rootClosed = false;
+
+    /**
+     * Used for parsing one top-level element at a time
+     */
+    std::unique_ptr<tinyxml2::XMLDocument> m_document;
+
+    std::string m_error;
+  };
+} // namespace xmltv
@@ -22,6 +22,8 @@ Programme::Programme(const tinyxml2::XMLElement* xml) : m_year(0)
   // Construct a basic event
   m_startTime = xmltv::Utilities::GetStdString(xml->Attribute("start"));
   m_endTime = xmltv::Utilities::GetStdString(xml->Attribute("stop"));
+  m_startTimestamp = Utilities::XmltvToUnixTime(m_startTime);
+  m_endTimestamp = Utilities::XmltvToUnixTime(m_endTime);
   m_channelName = Utilities::UrlDecode(xmltv::Utilities::GetStdString(xml->Attribute("channel")));
 
   // Title
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <ctime>
 #include <map>
 #include <memory>
 #include <string>
@@ -19,6 +20,11 @@ namespace tinyxml2
   class XMLElement;
 }
 
+namespace vbox
+{
+  class GuideCache;
+}
+
 namespace xmltv
 {
 
@@ -32,6 +38,8 @@ namespace xmltv
   {
     std::string role;
     std::string name;
+
+    bool operator==(const Actor& other) const { return role == other.role && name == other.name; }
   };
 
   /**
@@ -43,6 +51,14 @@ namespace xmltv
     std::vector<Actor> actors;
     std::vector<std::string> producers;
     std::vector<std::string> writers;
+
+    bool operator==(const Credits& other) const
+    {
+      return directors == other.directors &&
+        actors == other.actors &&
+        producers == other.producers &&
+        writers == other.writers;
+    }
   };
 
   /**
@@ -62,6 +78,24 @@ namespace xmltv
     Programme(const tinyxml2::XMLElement* xml);
     virtual ~Programme() = default;
 
+    bool operator==(const Programme& other) const
+    {
+      return m_startTime == other.m_startTime &&
+        m_endTime == other.m_endTime &&
+        m_channelName == other.m_channelName &&
+        m_title == other.m_title &&
+        m_description == other.m_description &&
+        m_icon == other.m_icon &&
+        m_subTitle == other.m_subTitle &&
+        m_seriesIds == other.m_seriesIds &&
+        m_year == other.m_year &&
+        m_starRating == other.m_starRating &&
+        m_credits == other.m_credits &&
+        m_categories == other.m_categories;
+    }
+
+    bool operator!=(const Programme& other) const { return !(*this == other); }
+
     const std::vector<std::string>& GetDirectors() const { return m_credits.directors; }
 
     const std::vector<Actor>& GetActors() const { return m_credits.actors; }
@@ -74,6 +108,14 @@ namespace xmltv
 
     std::string m_startTime;
     std::string m_endTime;
+
+    /**
+     * The start and end times as Unix timestamps, parsed once from
+     * m_startTime and m_endTime
+     */
+    time_t m_startTimestamp;
+    time_t m_endTimestamp;
+
     std::string m_channelName;
     std::string m_title;
     std::string m_description;
@@ -84,6 +126,13 @@ namespace xmltv
     std::string m_starRating;
 
   private:
+    friend class vbox::GuideCache;
+
+    /**
+     * Creates an empty programme, used when restoring cached programmes
+     */
+    Programme() : m_startTimestamp(0), m_endTimestamp(0), m_year(0) {}
+
     /**
      * Parses the credits from the specified <credits> element
      */
@@ -19,9 +19,31 @@ Schedule::Schedule(ChannelPtr& channel) : m_channel(channel)
 {
 }
 
+bool Schedule::operator==(const Schedule& other) const
+{
+  if (*m_channel != *other.m_channel)
+    return false;
+
+  return std::equal(
+    m_programmes.cbegin(),
+    m_programmes.cend(),
+    other.m_programmes.cbegin(),
+    other.m_programmes.cend(),
+    [](const ProgrammePtr& left, const ProgrammePtr& right) {
+      return *left == *right;
+    }
+  );
+}
+
 void Schedule::AddProgramme(ProgrammePtr programme)
 {
-  m_programmes.push_back(programme);
+  // Programmes normally arrive in order, so this is usually an append
+  auto it = std::upper_bound(m_programmes.cbegin(), m_programmes.cend(), programme->m_startTimestamp,
+                             [](time_t startTime, const ProgrammePtr& other) {
+                               return startTime < other->m_startTimestamp;
+                             });
+
+  m_programmes.insert(it, programme);
 }
 
 const ProgrammePtr Schedule::GetProgramme(int programmeUniqueId) const
@@ -40,22 +62,18 @@ const ProgrammePtr Schedule::GetProgramme(int programmeUniqueId) const
   return nullptr;
 }
 
-const Segment Schedule::GetSegment(time_t startTime, time_t endTime) const
+SegmentView Schedule::GetSegment(time_t startTime, time_t endTime) const
 {
-  Segment segment;
-
-  // Copy matching programmes to the segment
-  std::copy_if(
-    m_programmes.cbegin(),
-    m_programmes.cend(),
-    std::back_inserter(segment),
-    [startTime, endTime](const ProgrammePtr& programme) {
-      time_t programmeStartTime = Utilities::XmltvToUnixTime(programme->m_startTime);
-      time_t programmeEndTime = Utilities::XmltvToUnixTime(programme->m_endTime);
-
-      return programmeStartTime >= startTime && programmeEndTime <= endTime;
-    }
-  );
+  // Find the programmes that start within the interval, the view skips the
+  // ones among them that end after it
+  auto first = std::lower_bound(m_programmes.cbegin(), m_programmes.cend(), startTime,
+                                [](const ProgrammePtr& programme, time_t time) {
+                                  return programme->m_startTimestamp < time;
+                                });
+  auto last = std::upper_bound(first, m_programmes.cend(), endTime,
+                               [](time_t time, const ProgrammePtr& programme) {
+                                 return time < programme->m_startTimestamp;
+                               });
 
-  return segment;
+  return SegmentView(first, last, endTime);
 }
@@ -11,6 +11,9 @@
 #include "Channel.h"
 #include "Programme.h"
 
+#include <cstddef>
+#include <ctime>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -27,6 +30,79 @@ namespace xmltv
   typedef std::shared_ptr<Schedule> SchedulePtr;
   typedef std::vector<ProgrammePtr> Segment;
 
+  /**
+   * A read-only view of the programmes in a range of a schedule that end no
+   * later than a specified time. Programmes may overlap, so a programme
+   * that ends too late can be followed by ones that don't, which is why
+   * they are skipped while iterating. The view is only valid for as long as
+   * the schedule it was obtained from exists and is not modified
+   */
+  class SegmentView
+  {
+  public:
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = ProgrammePtr;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ProgrammePtr*;
+      using reference = const ProgrammePtr&;
+
+      const_iterator(Segment::const_iterator it, Segment::const_iterator end, time_t endTime)
+        : m_it(it), m_end(end), m_endTime(endTime)
+      {
+        SkipLateProgrammes();
+      }
+
+      reference operator*() const { return *m_it; }
+      pointer operator->() const { return &*m_it; }
+
+      const_iterator& operator++()
+      {
+        ++m_it;
+        SkipLateProgrammes();
+        return *this;
+      }
+
+      const_iterator operator++(int)
+      {
+        const_iterator previous = *this;
+        ++*this;
+        return previous;
+      }
+
+      bool operator==(const const_iterator& other) const { return m_it == other.m_it; }
+      bool operator!=(const const_iterator& other) const { return m_it != other.m_it; }
+
+    private:
+      void SkipLateProgrammes()
+      {
+        while (m_it != m_end && (*m_it)->m_endTimestamp > m_endTime)
+          ++m_it;
+      }
+
+      Segment::const_iterator m_it;
+      Segment::const_iterator m_end;
+      time_t m_endTime;
+    };
+
+    SegmentView(Segment::const_iterator begin, Segment::const_iterator end, time_t endTime)
+      : m_begin(begin), m_end(end), m_endTime(endTime)
+    {
+    }
+
+    const_iterator begin() const { return const_iterator(m_begin, m_end, m_endTime); }
+    const_iterator end() const { return const_iterator(m_end, m_end, m_endTime); }
+    size_t size() const { return static_cast<size_t>(std::distance(begin(), end())); }
+    bool empty() const { return begin() == end(); }
+
+  private:
+    Segment::const_iterator m_begin;
+    Segment::const_iterator m_end;
+    time_t m_endTime;
+  };
+
   /**
    * Represents a schedule for a channel
    */
@@ -40,7 +116,16 @@ namespace xmltv
     Schedule(ChannelPtr& channel);
 
     /**
-     * Adds the specified programme to the specified channel's schedule
+     * Schedules are equal when they are for the same channel and contain the
+     * same programmes in the same order
+     */
+    bool operator==(const Schedule& other) const;
+
+    bool operator!=(const Schedule& other) const { return !(*this == other); }
+
+    /**
+     * Adds the specified programme to the specified channel's schedule. The
+     * programmes are kept ordered by their start time
      * @param programme a programme
      */
     void AddProgramme(ProgrammePtr programme);
@@ -53,12 +138,18 @@ namespace xmltv
 
     /**
      * Returns a schedule segment containing all programmes between the
-     * specified timestamps
+     * specified timestamps, i.e. the programmes that start at or after the
+     * start time and end at or before the end time. Programmes may overlap
      * @param startTime the start time
      * @param endTime the end time
-     * @return list of matching programmes
+     * @return view of the matching programmes
      */
-    const Segment GetSegment(time_t startTime, time_t endTime) const;
+    SegmentView GetSegment(time_t startTime, time_t endTime) const;
+
+    /**
+     * @return all programmes, ordered by start time
+     */
+    const Segment& GetProgrammes() const { return m_programmes; }
 
     /**
      * @return the channel this schedule is for
@@ -71,7 +162,11 @@ namespace xmltv
     size_t GetLength() const { return m_programmes.size(); }
 
   private:
+    /**
+     * The programmes, ordered by start time
+     */
     Segment m_programmes;
+
     ChannelPtr m_channel;
   };
 } // namespace xmltv
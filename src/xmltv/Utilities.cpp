@@ -9,6 +9,8 @@
 #include "Utilities.h"
 
 #include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <iomanip>
 #include <iterator>
 #include <sstream>
@@ -48,7 +50,7 @@ namespace
     return (((MakeTime(y, m, mday) - MakeTime(1970 + 99, 12, 1)) * 24 + hour) * 60 + min) * 60 + sec;
   }
 
-  long long ParseDateTime(const std::string& strDate)
+  long long ParseDateTimeSlow(const std::string& strDate)
   {
     int year = 2000;
     int mon = 1;
@@ -70,6 +72,66 @@ namespace
     return GetUTCTime(year, mon, mday, hour, min, sec) - offset_of_date;
   }
 
+  /**
+   * @return whether all the specified characters are digits. Checks every
+   * character without branching so the compiler can vectorize the loop
+   */
+  bool AreDigits(const char* str, size_t length)
+  {
+    unsigned int invalid = 0;
+
+    for (size_t i = 0; i < length; i++)
+      invalid |= static_cast<unsigned int>(static_cast<unsigned char>(str[i]) - '0') > 9;
+
+    return invalid == 0;
+  }
+
+  int ToNumber(const char* str, size_t length)
+  {
+    int number = 0;
+
+    for (size_t i = 0; i < length; i++)
+      number = number * 10 + (str[i] - '0');
+
+    return number;
+  }
+
+  /**
+   * Parses well-formed timestamps ("YYYYMMDDhhmmss", optionally followed by
+   * a "+hhmm" or "-hhmm" timezone offset) directly. Anything else is left
+   * to the sscanf based parser so that the results are always the same
+   */
+  long long ParseDateTime(const std::string& strDate)
+  {
+    const char* str = strDate.c_str();
+    size_t length = strDate.length();
+
+    if (length < 14 || !AreDigits(str, 14))
+      return ParseDateTimeSlow(strDate);
+
+    long long time = GetUTCTime(ToNumber(str, 4), ToNumber(str + 4, 2), ToNumber(str + 6, 2), ToNumber(str + 8, 2),
+                                ToNumber(str + 10, 2), ToNumber(str + 12, 2));
+
+    // Skip the whitespace before the timezone offset
+    size_t pos = 14;
+    while (pos < length && std::isspace(static_cast<unsigned char>(str[pos])))
+      pos++;
+
+    if (pos == length)
+      return time;
+
+    char offset_sign = str[pos];
+
+    if ((offset_sign != '+' && offset_sign != '-') || length - pos < 5 || !AreDigits(str + pos + 1, 4))
+      return ParseDateTimeSlow(strDate);
+
+    long offset_of_date = (ToNumber(str + pos + 1, 2) * 60 + ToNumber(str + pos + 3, 2)) * 60;
+    if (offset_sign == '-')
+      offset_of_date = -offset_of_date;
+
+    return time - offset_of_date;
+  }
+
 } // unnamed namespace
 
 std::string Utilities::GetTimezoneOffset(const std::string timestamp)
@@ -109,6 +171,11 @@ time_t Utilities::XmltvToUnixTime(const std::string& time)
   return static_cast<time_t>(ParseDateTime(time));
 }
 
+time_t Utilities::XmltvToUnixTimeSlow(const std::string& time)
+{
+  return static_cast<time_t>(ParseDateTimeSlow(time));
+}
+
 std::string Utilities::UnixTimeToXmltv(const time_t timestamp, const std::string tzOffset /* = ""*/)
 {
   // Adjust the timestamp according to the timezone
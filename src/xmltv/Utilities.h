@@ -55,6 +55,15 @@ namespace xmltv
       */
     static time_t XmltvToUnixTime(const std::string& time);
 
+    /**
+      * The sscanf based implementation XmltvToUnixTime() falls back to for
+      * timestamps that aren't well-formed. Both must return the same result
+      * for every input, which the differential fuzz test checks
+      * @param time e.g. "20120228001500+0200"
+      * @return a UTC UNIX timestamp
+      */
+    static time_t XmltvToUnixTimeSlow(const std::string& time);
+
     /**
       * Converts a UTC time_t to an XMLTV datetime string, optionally adjusted
       * for the specified timezone offset
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "../Programme.h"
+#include "../Utilities.h"
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tinyxml2.h>
+
+using namespace xmltv;
+
+namespace
+{
+  const int NUM_PROGRAMMES = 10000;
+  const int PROGRAMME_LENGTH = 30 * 60;
+  const int REPETITIONS = 100;
+
+  // 2021-01-01 00:00:00 UTC
+  const time_t GUIDE_START = 1609459200;
+
+  double GetElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /**
+   * Sums the start and end times of every programme REPETITIONS times
+   * @return the sum, so that the work can't be optimized away
+   */
+  template<typename Function>
+  long long SumTimes(const std::vector<ProgrammePtr>& programmes, Function getTimes)
+  {
+    long long sum = 0;
+
+    for (int i = 0; i < REPETITIONS; i++)
+    {
+      for (const auto& programme : programmes)
+        sum += getTimes(*programme);
+    }
+
+    return sum;
+  }
+} // unnamed namespace
+
+/**
+ * Compares parsing the XMLTV start and end times of programmes on every
+ * access, with both the direct and the sscanf based parser, with reading
+ * the timestamps parsed at construction
+ */
+int main()
+{
+  std::stringstream ss;
+  ss << "<tv>";
+
+  for (int i = 0; i < NUM_PROGRAMMES; i++)
+  {
+    time_t time = GUIDE_START + i * PROGRAMME_LENGTH;
+    ss << "<programme start=\"" << Utilities::UnixTimeToXmltv(time, "+0200") << "\" stop=\""
+       << Utilities::UnixTimeToXmltv(time + PROGRAMME_LENGTH, "+0200") << "\" channel=\"channel\"/>";
+  }
+
+  ss << "</tv>";
+
+  tinyxml2::XMLDocument document;
+  if (document.Parse(ss.str().c_str()) != tinyxml2::XML_SUCCESS)
+  {
+    std::fprintf(stderr, "Failed to parse the generated guide\n");
+    return 1;
+  }
+
+  std::vector<ProgrammePtr> programmes;
+  for (const tinyxml2::XMLElement* element = document.RootElement()->FirstChildElement("programme");
+       element != nullptr; element = element->NextSiblingElement("programme"))
+  {
+    programmes.push_back(ProgrammePtr(new Programme(element)));
+  }
+
+  const double numLookups = 2.0 * NUM_PROGRAMMES * REPETITIONS;
+
+  auto start = std::chrono::steady_clock::now();
+  long long parsedSum = SumTimes(programmes, [](const Programme& programme) {
+    return static_cast<long long>(Utilities::XmltvToUnixTime(programme.m_startTime)) +
+           Utilities::XmltvToUnixTime(programme.m_endTime);
+  });
+  double parsedTime = GetElapsedMilliseconds(start);
+
+  start = std::chrono::steady_clock::now();
+  long long slowSum = SumTimes(programmes, [](const Programme& programme) {
+    return static_cast<long long>(Utilities::XmltvToUnixTimeSlow(programme.m_startTime)) +
+           Utilities::XmltvToUnixTimeSlow(programme.m_endTime);
+  });
+  double slowTime = GetElapsedMilliseconds(start);
+
+  start = std::chrono::steady_clock::now();
+  long long cachedSum = SumTimes(programmes, [](const Programme& programme) {
+    return static_cast<long long>(programme.m_startTimestamp) + programme.m_endTimestamp;
+  });
+  double cachedTime = GetElapsedMilliseconds(start);
+
+  std::printf("%d programmes, %d repetitions\n", NUM_PROGRAMMES, REPETITIONS);
+  std::printf("  XmltvToUnixTime():        %10.1f ms, %8.1f ns per timestamp\n", parsedTime,
+              parsedTime * 1e6 / numLookups);
+  std::printf("  XmltvToUnixTimeSlow():    %10.1f ms, %8.1f ns per timestamp\n", slowTime,
+              slowTime * 1e6 / numLookups);
+  std::printf("  cached timestamps:        %10.1f ms, %8.1f ns per timestamp\n", cachedTime,
+              cachedTime * 1e6 / numLookups);
+
+  if (parsedSum != cachedSum || slowSum != cachedSum)
+  {
+    std::fprintf(stderr, "The parsed and cached timestamps differ\n");
+    return 1;
+  }
+
+  return 0;
+}
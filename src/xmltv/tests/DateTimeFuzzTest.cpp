@@ -0,0 +1,192 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "../Utilities.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace xmltv;
+
+namespace
+{
+  const unsigned int DEFAULT_SEED = 20210101;
+  const int DEFAULT_ITERATIONS = 1000000;
+  const int MAX_REPORTED_MISMATCHES = 20;
+
+  /**
+   * Timezone suffixes, both valid and malformed
+   */
+  const std::vector<std::string> TIMEZONE_SUFFIXES = {
+    "", "+0000", "+0200", "-0500", "+1400", "-1200", "+9999", "-0000",
+    " +0200", "  -0330", "\t+0100", "\n-0100", " ",
+    "+02", "+020", "-1", "+", "-", "+02:00", "-05:30", "Z", "UTC", "GMT+1",
+    "+0200 ", "+02000", "+0200abc", "+ 200", "+-200", "++0200", "+02a0", "+a200",
+    "*0200", "0200", " 0200"};
+
+  /**
+   * Characters random mutations are drawn from. Digits, signs and
+   * whitespace are overrepresented since they are what the parsers treat
+   * specially
+   */
+  const std::string MUTATION_CHARACTERS = "0123456789012345678901234567890123456789+-+- \t\n\r\v\fZT:.ax\x7f\x80\xff";
+
+  class Generator
+  {
+  public:
+    explicit Generator(unsigned int seed) : m_random(seed) {}
+
+    int Number(int min, int max) { return std::uniform_int_distribution<int>(min, max)(m_random); }
+
+    std::string Digits(int count)
+    {
+      std::string digits;
+
+      for (int i = 0; i < count; i++)
+        digits += static_cast<char>('0' + Number(0, 9));
+
+      return digits;
+    }
+
+    /**
+     * @return fourteen random digits, so every field can be out of range
+     */
+    std::string RandomDateTime() { return Digits(14); }
+
+    /**
+     * @return a timestamp whose fields are within their normal range
+     */
+    std::string ValidDateTime()
+    {
+      char buffer[15];
+      std::snprintf(buffer, sizeof(buffer), "%04d%02d%02d%02d%02d%02d", Number(1900, 2100), Number(1, 12),
+                    Number(1, 31), Number(0, 23), Number(0, 59), Number(0, 59));
+      return buffer;
+    }
+
+    std::string TimezoneSuffix()
+    {
+      // Mostly well-formed offsets with random digits, sometimes one of the
+      // special cases
+      if (Number(0, 2) == 0)
+        return TIMEZONE_SUFFIXES[Number(0, static_cast<int>(TIMEZONE_SUFFIXES.size()) - 1)];
+
+      std::string suffix(Number(0, 2), ' ');
+      return suffix + (Number(0, 1) ? '+' : '-') + Digits(4);
+    }
+
+    std::string Truncate(const std::string& input)
+    {
+      return input.substr(0, Number(0, static_cast<int>(input.length())));
+    }
+
+    std::string Mutate(std::string input)
+    {
+      int mutations = Number(1, 3);
+
+      for (int i = 0; i < mutations; i++)
+      {
+        char c = MUTATION_CHARACTERS[Number(0, static_cast<int>(MUTATION_CHARACTERS.length()) - 1)];
+        int position = Number(0, static_cast<int>(input.length()));
+
+        switch (Number(0, 2))
+        {
+          case 0: // replace
+            if (!input.empty())
+              input[position % input.length()] = c;
+            break;
+          case 1: // insert
+            input.insert(input.begin() + position, c);
+            break;
+          default: // delete
+            if (!input.empty())
+              input.erase(position % input.length(), 1);
+            break;
+        }
+      }
+
+      return input;
+    }
+
+    std::string Next()
+    {
+      std::string input = (Number(0, 1) ? ValidDateTime() : RandomDateTime()) + TimezoneSuffix();
+
+      switch (Number(0, 3))
+      {
+        case 0:
+          return Truncate(input);
+        case 1:
+          return Mutate(input);
+        default:
+          return input;
+      }
+    }
+
+  private:
+    std::mt19937 m_random;
+  };
+
+  std::string Escape(const std::string& input)
+  {
+    std::string escaped;
+
+    for (char c : input)
+    {
+      unsigned char uc = static_cast<unsigned char>(c);
+
+      if (uc < 0x20 || uc >= 0x7f)
+      {
+        char buffer[5];
+        std::snprintf(buffer, sizeof(buffer), "\\x%02x", uc);
+        escaped += buffer;
+      }
+      else
+        escaped += c;
+    }
+
+    return escaped;
+  }
+} // unnamed namespace
+
+/**
+ * Differential fuzz test which checks that XmltvToUnixTime() returns the
+ * same result as the sscanf based XmltvToUnixTimeSlow() for random,
+ * out-of-range, truncated and mutated timestamps with all kinds of timezone
+ * suffixes. Usage: datetime_fuzz_test [seed] [iterations]
+ */
+int main(int argc, char** argv)
+{
+  unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : DEFAULT_SEED;
+  int iterations = argc > 2 ? std::atoi(argv[2]) : DEFAULT_ITERATIONS;
+
+  Generator generator(seed);
+  int mismatches = 0;
+
+  for (int i = 0; i < iterations; i++)
+  {
+    std::string input = generator.Next();
+    time_t expected = Utilities::XmltvToUnixTimeSlow(input);
+    time_t actual = Utilities::XmltvToUnixTime(input);
+
+    if (actual != expected)
+    {
+      if (mismatches < MAX_REPORTED_MISMATCHES)
+        std::fprintf(stderr, "Mismatch for \"%s\": expected %lld, got %lld\n", Escape(input).c_str(),
+                     static_cast<long long>(expected), static_cast<long long>(actual));
+
+      mismatches++;
+    }
+  }
+
+  std::printf("%d timestamps checked with seed %u, %d mismatches\n", iterations, seed, mismatches);
+  return mismatches == 0 ? 0 : 1;
+}
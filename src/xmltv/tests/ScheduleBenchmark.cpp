@@ -0,0 +1,168 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "../Channel.h"
+#include "../Programme.h"
+#include "../Schedule.h"
+#include "../Utilities.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tinyxml2.h>
+
+using namespace xmltv;
+
+namespace
+{
+  const int NUM_CHANNELS = 300;
+  const int NUM_DAYS = 14;
+  const int PROGRAMME_LENGTH = 30 * 60;
+  const int WINDOW_LENGTH = 24 * 60 * 60;
+  const int REPETITIONS = 10;
+
+  // 2021-01-01 00:00:00 UTC
+  const time_t GUIDE_START = 1609459200;
+
+  /**
+   * @return an XMLTV document containing one channel's guide
+   */
+  std::string CreateChannelGuide(const std::string& channelId)
+  {
+    std::stringstream ss;
+    ss << "<tv>";
+
+    for (time_t time = GUIDE_START; time < GUIDE_START + NUM_DAYS * 24 * 60 * 60; time += PROGRAMME_LENGTH)
+    {
+      ss << "<programme start=\"" << Utilities::UnixTimeToXmltv(time, "+0200") << "\" stop=\""
+         << Utilities::UnixTimeToXmltv(time + PROGRAMME_LENGTH, "+0200") << "\" channel=\"" << channelId << "\">"
+         << "<title>Programme " << time << "</title></programme>";
+    }
+
+    ss << "</tv>";
+    return ss.str();
+  }
+
+  /**
+   * Finds the programmes within the interval the way GetSegment() used to,
+   * by looking at every programme
+   */
+  size_t GetSegmentSizeLinear(const Schedule& schedule, time_t startTime, time_t endTime)
+  {
+    size_t size = 0;
+
+    for (const auto& programme : schedule.GetProgrammes())
+    {
+      if (programme->m_startTimestamp >= startTime && programme->m_endTimestamp <= endTime)
+        size++;
+    }
+
+    return size;
+  }
+
+  double GetElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /**
+   * Asks for every channel's guide one window at a time, the way Kodi
+   * does when it populates the EPG
+   * @return the total number of programmes found
+   */
+  template<typename Function>
+  size_t QueryAllWindows(const std::vector<SchedulePtr>& schedules, Function getSegmentSize)
+  {
+    size_t total = 0;
+
+    for (int day = 0; day < NUM_DAYS; day++)
+    {
+      time_t startTime = GUIDE_START + day * WINDOW_LENGTH;
+
+      for (const auto& schedule : schedules)
+        total += getSegmentSize(*schedule, startTime, startTime + WINDOW_LENGTH);
+    }
+
+    return total;
+  }
+} // unnamed namespace
+
+/**
+ * Measures Schedule::AddProgramme() and Schedule::GetSegment() on a guide
+ * of NUM_DAYS days for NUM_CHANNELS channels
+ */
+int main()
+{
+  std::vector<SchedulePtr> schedules;
+  size_t numProgrammes = 0;
+  double buildTime = 0;
+
+  for (int i = 0; i < NUM_CHANNELS; i++)
+  {
+    std::string channelId = "channel" + std::to_string(i);
+    std::string guide = CreateChannelGuide(channelId);
+
+    tinyxml2::XMLDocument document;
+    if (document.Parse(guide.c_str()) != tinyxml2::XML_SUCCESS)
+    {
+      std::fprintf(stderr, "Failed to parse the generated guide\n");
+      return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ChannelPtr channel(new Channel(channelId, channelId));
+    SchedulePtr schedule(new Schedule(channel));
+
+    for (const tinyxml2::XMLElement* element = document.RootElement()->FirstChildElement("programme");
+         element != nullptr; element = element->NextSiblingElement("programme"))
+    {
+      schedule->AddProgramme(ProgrammePtr(new Programme(element)));
+    }
+
+    buildTime += GetElapsedMilliseconds(start);
+    numProgrammes += schedule->GetLength();
+    schedules.push_back(schedule);
+  }
+
+  std::printf("%d channels x %d days, %zu programmes\n", NUM_CHANNELS, NUM_DAYS, numProgrammes);
+  std::printf("  building the schedules:   %10.1f ms\n", buildTime);
+
+  const int numQueries = NUM_CHANNELS * NUM_DAYS * REPETITIONS;
+  size_t binarySearchTotal = 0;
+  size_t linearTotal = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < REPETITIONS; i++)
+    binarySearchTotal += QueryAllWindows(schedules, [](const Schedule& schedule, time_t startTime, time_t endTime) {
+      return schedule.GetSegment(startTime, endTime).size();
+    });
+  double binarySearchTime = GetElapsedMilliseconds(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < REPETITIONS; i++)
+    linearTotal += QueryAllWindows(schedules, GetSegmentSizeLinear);
+  double linearTime = GetElapsedMilliseconds(start);
+
+  std::printf("  GetSegment():             %10.1f ms, %8.0f ns per call\n", binarySearchTime,
+              binarySearchTime * 1e6 / numQueries);
+  std::printf("  linear scan:              %10.1f ms, %8.0f ns per call\n", linearTime,
+              linearTime * 1e6 / numQueries);
+
+  if (binarySearchTotal != linearTotal)
+  {
+    std::fprintf(stderr, "GetSegment() found %zu programmes, the linear scan %zu\n", binarySearchTotal,
+                 linearTotal);
+    return 1;
+  }
+
+  return 0;
+}
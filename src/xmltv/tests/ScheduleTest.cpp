@@ -0,0 +1,162 @@
+/*
+ *  Copyright (C) 2015-2021 Team Kodi (https://kodi.tv)
+ *  Copyright (C) 2015 Sam Stenvall
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSE.md for more information.
+ */
+
+#include "../Channel.h"
+#include "../Programme.h"
+#include "../Schedule.h"
+#include "../Utilities.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tinyxml2.h>
+
+using namespace xmltv;
+
+namespace
+{
+  const unsigned int DEFAULT_SEED = 20210101;
+  const int NUM_SCHEDULES = 200;
+  const int MAX_PROGRAMMES = 60;
+  const int QUERIES_PER_SCHEDULE = 200;
+  const int MAX_REPORTED_MISMATCHES = 20;
+
+  // 2021-01-01 00:00:00 UTC
+  const time_t GUIDE_START = 1609459200;
+  const int GUIDE_LENGTH = 2 * 24 * 60 * 60;
+
+  ProgrammePtr CreateProgramme(time_t startTime, time_t endTime)
+  {
+    std::stringstream ss;
+    ss << "<programme start=\"" << Utilities::UnixTimeToXmltv(startTime, "+0000") << "\" stop=\""
+       << Utilities::UnixTimeToXmltv(endTime, "+0000") << "\" channel=\"channel\">"
+       << "<title>Programme " << startTime << "-" << endTime << "</title></programme>";
+
+    tinyxml2::XMLDocument document;
+    if (document.Parse(ss.str().c_str()) != tinyxml2::XML_SUCCESS)
+      return nullptr;
+
+    return ProgrammePtr(new Programme(document.RootElement()));
+  }
+
+  /**
+   * Finds the programmes within the interval by looking at every programme
+   */
+  Segment GetSegmentLinear(const Schedule& schedule, time_t startTime, time_t endTime)
+  {
+    Segment segment;
+
+    for (const auto& programme : schedule.GetProgrammes())
+    {
+      if (programme->m_startTimestamp >= startTime && programme->m_endTimestamp <= endTime)
+        segment.push_back(programme);
+    }
+
+    return segment;
+  }
+
+  /**
+   * @return whether GetSegment() returns the same programmes in the same
+   * order as the linear scan
+   */
+  bool CheckSegment(const Schedule& schedule, time_t startTime, time_t endTime, int& mismatches)
+  {
+    Segment expected = GetSegmentLinear(schedule, startTime, endTime);
+    SegmentView view = schedule.GetSegment(startTime, endTime);
+    Segment actual(view.begin(), view.end());
+
+    if (actual == expected && view.size() == expected.size() && view.empty() == expected.empty())
+      return true;
+
+    if (mismatches < MAX_REPORTED_MISMATCHES)
+      std::fprintf(stderr, "Mismatch for %lld-%lld: expected %zu programmes, got %zu\n",
+                   static_cast<long long>(startTime), static_cast<long long>(endTime), expected.size(),
+                   actual.size());
+
+    mismatches++;
+    return false;
+  }
+} // unnamed namespace
+
+/**
+ * Compares Schedule::GetSegment() with a linear scan on schedules with
+ * overlapping programmes that are added out of order
+ *
+ * Usage: schedule_test [seed]
+ */
+int main(int argc, char** argv)
+{
+  unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : DEFAULT_SEED;
+  std::mt19937 random(seed);
+  auto number = [&random](int min, int max) { return std::uniform_int_distribution<int>(min, max)(random); };
+
+  int queries = 0;
+  int mismatches = 0;
+
+  // A long programme that starts first must not hide the shorter ones that
+  // start after it, nor be included itself
+  {
+    ChannelPtr channel(new Channel("channel", "channel"));
+    Schedule schedule(channel);
+    schedule.AddProgramme(CreateProgramme(GUIDE_START, GUIDE_START + 4 * 3600));
+    schedule.AddProgramme(CreateProgramme(GUIDE_START + 3600, GUIDE_START + 5400));
+    schedule.AddProgramme(CreateProgramme(GUIDE_START + 5400, GUIDE_START + 6 * 3600));
+    schedule.AddProgramme(CreateProgramme(GUIDE_START + 5400, GUIDE_START + 7200));
+
+    for (time_t endTime : {GUIDE_START + 5400, GUIDE_START + 7200, GUIDE_START + 4 * 3600, GUIDE_START + 6 * 3600})
+    {
+      CheckSegment(schedule, GUIDE_START, endTime, mismatches);
+      queries++;
+    }
+  }
+
+  for (int i = 0; i < NUM_SCHEDULES; i++)
+  {
+    ChannelPtr channel(new Channel("channel", "channel"));
+    Schedule schedule(channel);
+    std::vector<time_t> boundaries;
+
+    // Programmes of up to six hours are added in random order, so many of
+    // them overlap and some have the same start time or are empty
+    int numProgrammes = number(0, MAX_PROGRAMMES);
+
+    for (int j = 0; j < numProgrammes; j++)
+    {
+      time_t startTime = GUIDE_START + number(0, GUIDE_LENGTH / 60) * 60;
+      time_t endTime = startTime + number(0, 6 * 60) * 60;
+
+      schedule.AddProgramme(CreateProgramme(startTime, endTime));
+      boundaries.push_back(startTime);
+      boundaries.push_back(endTime);
+    }
+
+    for (int j = 0; j < QUERIES_PER_SCHEDULE; j++)
+    {
+      time_t startTime = GUIDE_START + number(-60, GUIDE_LENGTH / 60) * 60;
+      time_t endTime = startTime + number(0, 12 * 60) * 60;
+
+      // Also use the exact programme boundaries
+      if (!boundaries.empty() && j % 2 == 0)
+      {
+        startTime = boundaries[number(0, static_cast<int>(boundaries.size()) - 1)];
+        endTime = std::max(startTime, boundaries[number(0, static_cast<int>(boundaries.size()) - 1)]);
+      }
+
+      CheckSegment(schedule, startTime, endTime, mismatches);
+      queries++;
+    }
+  }
+
+  std::printf("%d segments checked with seed %u, %d mismatches\n", queries, seed, mismatches);
+  return mismatches == 0 ? 0 : 1;
+}